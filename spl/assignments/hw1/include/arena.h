@@ -0,0 +1,23 @@
+#ifndef ARENA_H
+#define ARENA_H
+#include <vector>
+#include <cstddef>
+
+// bump allocator: memory is handed out from big blocks and only
+// given back all at once, when the arena is destroyed.
+class Arena {
+    public:
+        Arena(size_t block_size = 1 << 20);
+        ~Arena();
+        char* allocate(size_t size);
+
+    private:
+        Arena(const Arena&);
+        Arena& operator=(const Arena&);
+
+        size_t _block_size;
+        std::vector<char*> _blocks;
+        char* _next;
+        size_t _left;
+};
+#endif
@@ -0,0 +1,44 @@
+#ifndef CONFFILE_H
+#define CONFFILE_H
+#include <string>
+#include <string_view>
+#include <vector>
+#include "typedef.h"
+
+// read-only, memory mapped configuration file.
+// lines and fields are views into the mapping, so they are only valid
+// while the file is open; copy whatever has to outlive it.
+// a pipe (or stdin) can't be mapped, it is read through a buffer instead,
+// and then a line is only valid until the next one is read. a read error
+// ends the lines like the end of the file does, failed() tells them apart.
+class ConfFile {
+    public:
+        ConfFile();
+        ~ConfFile();
+        bool open(const std::string& filename);
+        bool open(int fd);
+        void close();
+        bool readLine(std::string_view& line);
+        bool readFields(Fields& fields, char separator);
+        bool failed() const;
+
+        static void split(std::string_view line, char separator, Fields& fields);
+        static int toInt(std::string_view str);
+
+    private:
+        ConfFile(const ConfFile&);
+        ConfFile& operator=(const ConfFile&);
+        bool fill();
+
+        static const size_t BUFFER_SIZE = 1 << 16;
+
+        const char* _data;
+        size_t _size;
+        size_t _pos;
+        // only set while reading through the buffer, not owned
+        int _fd;
+        bool _eof;
+        bool _failed;
+        std::vector<char> _buffer;
+};
+#endif
@@ -1,22 +1,27 @@
 #ifndef COURSE_H
 #define COURSE_H
-#include <string>
-#include <vector>
-#include <fstream>
 #include "typedef.h"
 
 class Course {
     public:
-        Course(int weekday, std::string course_id, int room);
-        bool addStudent(Student* student);
-        void print(std::string filename);
+        Course(int weekday, Handle course_index, int room);
+        bool takeSeat();
+        void freeSeat();
+        void addSeat(Handle seat, Seats& seats);
+        void removeSeat(Handle seat, Seats& seats);
+        void print(OutputFile& output, const Registry& registry) const;
+        void getSeats(Handles& seats, const Registry& registry) const;
         int getWeekday() const;
-        std::string getCourseId() const;
+        Handle getCourseIndex() const;
+        int getCapacity() const;
 
     private:
         int _weekday;
-        std::string _course_id;
+        // interned course id, shared by all the sections of a course
+        Handle _course_index;
+        int _capacity;
         int _room;
-        Students _students;
+        Handle _first_seat;
+        Handle _last_seat;
 };
 #endif
@@ -0,0 +1,72 @@
+#ifndef EVENTENROLLMENT_H
+#define EVENTENROLLMENT_H
+#include <string>
+#include <string_view>
+#include <vector>
+#include <stdint.h>
+#include "typedef.h"
+
+// add/drop traffic on top of an enrollment. events come in time order:
+//   TIME,+,STUD-ID,COURSE-ID   enroll: the first section with room, or
+//                              the end of the course id's waitlist
+//   TIME,-,STUD-ID,COURSE-ID   drop the seats or the waitlist place
+// every course id keeps one FIFO waitlist for all of its sections, so a
+// seat dropped in any section goes straight to whoever waited longest.
+// rosters and timetables are changed in place, so every event costs O(1)
+// plus a hash lookup (enrolling also looks at each section for room).
+// what every student holds is kept in an open addressing table, so a
+// lookup is one cache miss and not a bucket plus a node.
+class EventEnrollment {
+    public:
+        EventEnrollment(Registry& registry);
+        bool apply(const std::string& filename);
+
+    private:
+        EventEnrollment(const EventEnrollment&);
+        EventEnrollment& operator=(const EventEnrollment&);
+
+        // a student waiting for a course id, linked in arrival order
+        struct Waiting {
+            Handle student;
+            Handle course_index;
+            Handle prev;
+            Handle next;
+        };
+
+        // what a student holds of a course id: seats, or a waitlist
+        // place. a student who asked for the course id more than once
+        // before the events may sit in several sections, those seats are
+        // chained from the first one through _next_seat.
+        struct Holding {
+            uint64_t key;
+            Handle handle;
+            bool waiting;
+        };
+
+        static const uint64_t NO_KEY = ~0ull;
+
+        static uint64_t key(Handle student, Handle course_index);
+        size_t homeOf(uint64_t key) const;
+        size_t findHolding(uint64_t key) const;
+        Holding& addHolding(uint64_t key);
+        void removeHolding(size_t slot);
+        void indexSeats();
+        void enroll(Handle student, Handle course_index);
+        void drop(Handle student, Handle course_index);
+        void freeSeat(Handle course, Handle course_index);
+        void setNextSeat(Handle seat, Handle next);
+        Handle wait(Handle student, Handle course_index);
+        void unwait(Handle waiting);
+
+        Registry& _registry;
+        std::vector<Holding> _holdings;
+        size_t _holding_count;
+        std::vector<Waiting> _waiting;
+        Handles _free_waiting;
+        // per course index: waitlist head and tail
+        Handles _first_waiting;
+        Handles _last_waiting;
+        // per seat: the next seat of the same holding
+        Handles _next_seat;
+};
+#endif
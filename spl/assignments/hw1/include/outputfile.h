@@ -0,0 +1,42 @@
+#ifndef OUTPUTFILE_H
+#define OUTPUTFILE_H
+#include <string>
+#include <string_view>
+#include <vector>
+
+// output file that stays open for the whole run and only hits the disk
+// when its buffer fills up (or on flush/close), instead of an open,
+// a flush per line and a close for every printed object.
+class OutputFile {
+    public:
+        OutputFile();
+        ~OutputFile();
+        bool open(const std::string& filename);
+        bool open(int fd);
+        bool flush();
+        bool close();
+
+        OutputFile& operator<<(std::string_view str);
+        OutputFile& operator<<(char c);
+        OutputFile& operator<<(int num);
+        OutputFile& write(const void* data, size_t size);
+        size_t getBytesWritten() const;
+
+    private:
+        OutputFile(const OutputFile&);
+        OutputFile& operator=(const OutputFile&);
+        bool writeAll(const char* data, size_t size);
+
+        static const size_t BUFFER_SIZE = 1 << 20;
+
+        int _fd;
+        bool _owned;
+        std::vector<char> _buffer;
+        size_t _used;
+        // that made it to the file so far
+        size_t _written;
+        // a write failed since open, nothing more is written and close
+        // reports it
+        bool _failed;
+};
+#endif
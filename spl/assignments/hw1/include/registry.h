@@ -0,0 +1,56 @@
+#ifndef REGISTRY_H
+#define REGISTRY_H
+#include <string_view>
+#include "typedef.h"
+#include "stringtable.h"
+#include "course.h"
+#include "student.h"
+#include "seat.h"
+
+// owns every course, student and seat. objects live in flat arrays and
+// refer to each other by handle (their index), ids are interned once, so
+// enrollment never allocates per object and teardown frees a few blocks.
+// course ids are numbered densely, and every course id maps to its
+// sections in courses.conf order so the first section with room wins.
+// dropped seats are recycled, so their handles are not in any order.
+class Registry {
+    public:
+        Registry();
+        Handle addCourse(int weekday, std::string_view course_id, int room);
+        Handle addStudent(std::string_view student_id);
+        bool enroll(Handle student, Handle course);
+        Handle addSeat(Handle student, Handle course);
+        void removeSeat(Handle seat);
+
+        Handle findStudent(std::string_view student_id) const;
+        Handle findCourseIndex(std::string_view course_id) const;
+        const Handles* findSections(std::string_view course_id) const;
+        const Handles& getSections(Handle course_index) const;
+        size_t getCourseIdCount() const;
+
+        Course& getCourse(Handle course);
+        const Course& getCourse(Handle course) const;
+        const Student& getStudent(Handle student) const;
+        const Seat& getSeat(Handle seat) const;
+        size_t getCourseCount() const;
+        size_t getStudentCount() const;
+        size_t getSeatCount() const;
+        std::string_view getCourseId(Handle course_index) const;
+        std::string_view getStudentId(Handle student_id) const;
+
+    private:
+        Registry(const Registry&);
+        Registry& operator=(const Registry&);
+
+        StringTable _course_ids;
+        StringTable _student_ids;
+        Courses _courses;
+        Students _students;
+        Seats _seats;
+        // sections of every course id, by course index
+        std::vector<Handles> _sections;
+        // first student with every interned student id
+        Handles _student_by_id;
+        Handles _free_seats;
+};
+#endif
@@ -0,0 +1,67 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+#include <string>
+#include <ostream>
+#include "typedef.h"
+#include "registry.h"
+#include "shardedenrollment.h"
+#include "stats.h"
+
+// the matrixU run, one phase per method: load the courses, load the
+// students and what they ask for, enroll, print. threads == 0 keeps the
+// original student by student order.
+//
+// instead of the confs, the run can start from a state file saved by an
+// earlier (sharded) run plus a delta file of students who joined or
+// withdrew since; only the course ids they touch are enrolled again.
+//
+// streamStudents() reads students.conf from a pipe and prints every
+// student's timetable as soon as they are enrolled, so only the students
+// holding a seat (the course rosters) stay in memory until the end.
+//
+// applyEvents() replays add/drop events on top of the enrollment, with
+// a waitlist per course id.
+class Scheduler {
+    public:
+        Scheduler(size_t threads);
+        bool loadCourses(const std::string& filename);
+        bool loadStudents(const std::string& filename);
+        bool streamStudents(int input, const std::string& filename);
+        bool loadState(const std::string& filename, const std::string& delta_filename);
+        void enroll();
+        bool applyEvents(const std::string& filename);
+        bool printCourses(const std::string& filename) const;
+        bool printStudents(const std::string& filename) const;
+        bool saveState(const std::string& filename) const;
+        bool saveSnapshot(const std::string& filename) const;
+        void printMatching(std::ostream& output) const;
+        const Registry& getRegistry() const;
+        RunCounters getCounters() const;
+
+    private:
+        Scheduler(const Scheduler&);
+        Scheduler& operator=(const Scheduler&);
+
+        void queueStudent(Handle student, const Fields& tokens);
+        void enrollQueued();
+        void takeSeats(const Fields& tokens, Handles& courses);
+        void countProbes(size_t seated_at, size_t sections);
+
+        static const char* const STATE_HEADER;
+        static const int STATE_VERSION = 1;
+
+        size_t _threads;
+        Registry _registry;
+        ShardedEnrollment _sharded;
+        // of the sequential run, the sharded one keeps its own. printing
+        // only adds to bytes_written, so that much is mutable.
+        RunCounters _counters;
+        mutable size_t _bytes_written;
+        // the sequential run's requests, until enroll(): the course index
+        // of every known COURSE-ID, and where every student's start. the
+        // students were added one after the other from _first_queued.
+        Handle _first_queued;
+        Handles _queued_from;
+        Handles _queued;
+};
+#endif
@@ -0,0 +1,17 @@
+#ifndef SEAT_H
+#define SEAT_H
+#include "typedef.h"
+
+// a seat a student got in a course. seats are threaded on two lists:
+// the course roster, in enrollment order, and the student's timetable
+// for the course's weekday. both are doubly linked so a dropped seat
+// comes off them in O(1).
+struct Seat {
+    Handle student;
+    Handle course;
+    Handle prev_in_course;
+    Handle next_in_course;
+    Handle prev_in_day;
+    Handle next_in_day;
+};
+#endif
@@ -0,0 +1,56 @@
+#ifndef SHARDEDENROLLMENT_H
+#define SHARDEDENROLLMENT_H
+#include <vector>
+#include <boost/atomic.hpp>
+#include "typedef.h"
+#include "stats.h"
+
+// enrollment split by course id: sections of different course ids never
+// compete for seats, so each course id (a shard) is served on its own,
+// in arrival order, by a pool of threads. the seats every student got
+// are then added to their timetables in the order they were requested,
+// which gives exactly the result of the sequential run.
+//
+// requests can also be replayed from an earlier run together with the
+// section they got back then. a shard nobody left since keeps those
+// seats as they are and only serves the requests that are new; a shard
+// marked as changed is served again from its first request.
+class ShardedEnrollment {
+    public:
+        ShardedEnrollment(Registry& registry);
+        void addStudent(Handle student, const Fields& tokens);
+        void addStudent(Handle student, const Handles& course_indexes,
+                        const Handles& granted);
+        void markChanged(Handle course_index);
+        void run(size_t threads);
+        void save(OutputFile& output) const;
+        size_t getRequestCount(Handle course_index) const;
+        const RunCounters& getCounters() const;
+
+    private:
+        ShardedEnrollment(const ShardedEnrollment&);
+        ShardedEnrollment& operator=(const ShardedEnrollment&);
+
+        void addRequest(Handle course_index, Handle granted, bool replayed);
+        void serveShards();
+        void serveShard(Handle course_index);
+
+        Registry& _registry;
+        Handles _students;
+        // first request slot of every student, plus the end of the last one
+        std::vector<size_t> _first_slot;
+        // request slots of every course id, in arrival order
+        std::vector<std::vector<size_t> > _shards;
+        std::vector<bool> _changed;
+        // per request slot: the course id asked for, the section that
+        // served it (NO_HANDLE if none had room) and whether it was
+        // replayed from an earlier run
+        Handles _requested;
+        Handles _granted;
+        std::vector<bool> _replayed;
+        // sections probed by every shard, written by the thread serving it
+        std::vector<size_t> _probes;
+        RunCounters _counters;
+        boost::atomic<size_t> _next_shard;
+};
+#endif
@@ -0,0 +1,76 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+#include <string>
+#include <string_view>
+#include <stdint.h>
+#include "typedef.h"
+
+// binary copy of the enrollment result, laid out to be used straight
+// from an mmap: every table below is a flat array at an 8 byte aligned
+// offset, students and course ids also come sorted by id so a lookup is
+// a binary search. all numbers are native endian.
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t student_count;
+    uint32_t course_id_count;
+    uint32_t section_count;
+    uint64_t seat_count;
+    uint64_t strings_size;
+    uint64_t strings;           // char[strings_size], the ids
+    uint64_t student_names;     // SnapshotName[student_count]
+    uint64_t student_order;     // uint32_t[student_count], sorted by id
+    uint64_t timetable_first;   // uint64_t[student_count+1]
+    uint64_t timetable;         // SnapshotLine[seat_count], weekday order
+    uint64_t course_names;      // SnapshotName[course_id_count]
+    uint64_t course_order;      // uint32_t[course_id_count], sorted by id
+    uint64_t sections_first;    // uint32_t[course_id_count+1]
+    uint64_t sections;          // uint32_t[section_count], conf order
+    uint64_t section_lines;     // SnapshotLine[section_count], by section
+    uint64_t roster_first;      // uint64_t[section_count+1], by section
+    uint64_t roster;            // uint32_t[seat_count], student handles
+};
+
+struct SnapshotName {
+    uint64_t offset;
+    uint32_t length;
+    uint32_t unused;
+};
+
+// a timetable line or a section header: WEEKDAY COURSE-ID
+struct SnapshotLine {
+    uint32_t weekday;
+    uint32_t course_index;
+};
+
+class Snapshot {
+    public:
+        Snapshot();
+        ~Snapshot();
+        static bool save(const Registry& registry, const std::string& filename);
+
+        bool open(const std::string& filename);
+        void close();
+        bool printStudent(OutputFile& output, std::string_view student_id) const;
+        bool printCourse(OutputFile& output, std::string_view course_id) const;
+
+    private:
+        Snapshot(const Snapshot&);
+        Snapshot& operator=(const Snapshot&);
+
+        static const char MAGIC[8];
+        static const uint32_t VERSION = 1;
+
+        template <typename T> const T* table(uint64_t offset) const;
+        bool hasTable(uint64_t offset, uint64_t count, size_t size) const;
+        bool hasNames(uint64_t offset, uint32_t count) const;
+        bool isValid() const;
+        std::string_view name(const SnapshotName* names, uint32_t handle) const;
+        size_t lowerBound(const SnapshotName* names, const uint32_t* order,
+                          uint32_t count, std::string_view id) const;
+
+        const char* _data;
+        size_t _size;
+        const SnapshotHeader* _header;
+};
+#endif
@@ -0,0 +1,46 @@
+#ifndef STATS_H
+#define STATS_H
+#include <string>
+#include <vector>
+#include <ostream>
+
+// what an enrollment run did. a request is one COURSE-ID of a student:
+// it is granted a seat, rejected because every section of its course id
+// was full, or ignored when nobody teaches that course id. a probe is a
+// section checked for room (replayed seats don't probe anything).
+struct RunCounters {
+    size_t requests;
+    size_t unknown;
+    size_t probes;
+    size_t granted;
+    size_t rejected;
+    // of courses.out, students.out and the state file
+    size_t bytes_written;
+};
+
+// wall and cpu time of every phase of a run, printed as json together
+// with the counters. cpu time is the whole process's, so on more than
+// one thread it can be more than the wall time.
+class Stats {
+    public:
+        Stats();
+        void startPhase(const std::string& name);
+        void endPhase();
+        void print(std::ostream& output, size_t threads, const RunCounters& counters) const;
+
+    private:
+        struct Phase {
+            std::string name;
+            double wall;
+            double cpu;
+        };
+
+        static double wallTime();
+        static double cpuTime();
+
+        std::vector<Phase> _phases;
+        bool _running;
+        double _wall_start;
+        double _cpu_start;
+};
+#endif
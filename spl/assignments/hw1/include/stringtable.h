@@ -0,0 +1,38 @@
+#ifndef STRINGTABLE_H
+#define STRINGTABLE_H
+#include <string_view>
+#include <vector>
+#include "typedef.h"
+#include "arena.h"
+
+// interns strings: every distinct string is stored once, in an arena so
+// it never moves, and numbered densely in order of first appearance.
+class StringTable {
+    public:
+        StringTable();
+        Handle intern(std::string_view str);
+        Handle find(std::string_view str) const;
+        std::string_view get(Handle handle) const;
+        size_t size() const;
+
+    private:
+        StringTable(const StringTable&);
+        StringTable& operator=(const StringTable&);
+
+        // the string is kept next to its handle, so a probe compares it
+        // without going through _strings first.
+        struct Slot {
+            const char* data;
+            unsigned int size;
+            Handle handle;
+        };
+
+        size_t slotOf(std::string_view str) const;
+        void grow();
+
+        Arena _arena;
+        std::vector<std::string_view> _strings;
+        // open addressing hash of handles, NO_HANDLE marks an empty slot
+        std::vector<Slot> _slots;
+};
+#endif
@@ -1,19 +1,24 @@
 #ifndef STUDENT_H
 #define STUDENT_H
-#include <string>
-#include <vector>
-#include <fstream>
 #include "typedef.h"
 
 class Student {
     public:
-        Student(std::string student_id);
-        void addCourse(Course* course);
-        void print(std::string filename);
-        std::string getStudentId() const;
+        Student(Handle student_id);
+        void addSeat(Handle seat, int weekday, Seats& seats);
+        void removeSeat(Handle seat, int weekday, Seats& seats);
+        void print(OutputFile& output, const Registry& registry) const;
+        void getSeats(Handles& seats, const Registry& registry) const;
+        Handle getStudentId() const;
 
     private:
-        std::string _student_id;
-        Courses _courses;
+        // weekdays are a single digit
+        static const int WEEKDAYS = 10;
+
+        // interned student id
+        Handle _student_id;
+        // each weekday's seats are a circular list, kept by its last
+        // seat so appending and finding the first one are both O(1).
+        Handle _last_seat[WEEKDAYS];
 };
 #endif
@@ -1,8 +1,20 @@
 #ifndef TYPEDEF_H
 #define TYPEDEF_H
 #include <vector>
+#include <string_view>
 class Student;
 class Course;
-typedef std::vector<Student*> Students;
-typedef std::vector<Course*> Courses;
+class OutputFile;
+class Registry;
+struct Seat;
+
+// objects refer to each other by their index in the registry
+typedef unsigned int Handle;
+typedef std::vector<Handle> Handles;
+const Handle NO_HANDLE = ~0u;
+
+typedef std::vector<Student> Students;
+typedef std::vector<Course> Courses;
+typedef std::vector<Seat> Seats;
+typedef std::vector<std::string_view> Fields;
 #endif
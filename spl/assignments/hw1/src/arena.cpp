@@ -0,0 +1,39 @@
+#include <vector>
+#include <cstdlib>
+#include <new>
+#include "../include/arena.h"
+using namespace std;
+
+Arena::Arena(size_t block_size):
+    _block_size(block_size),
+    _blocks(),
+    _next(0),
+    _left(0)
+{
+}
+
+Arena::~Arena() {
+    for (size_t i = 0; i < _blocks.size(); ++i) {
+        free(_blocks[i]);
+    }
+}
+
+char* Arena::allocate(size_t size) {
+    if (size > _left) {
+        // whatever is left in the current block is wasted.
+        size_t block_size = (size > _block_size) ? size : _block_size;
+        char* block = static_cast<char*>(malloc(block_size));
+        if (block == 0) {
+            throw bad_alloc();
+        }
+
+        _blocks.push_back(block);
+        _next = block;
+        _left = block_size;
+    }
+
+    char* data = _next;
+    _next += size;
+    _left -= size;
+    return data;
+}
@@ -0,0 +1,72 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <cstdlib>
+#include <ctime>
+#include <sys/resource.h>
+#include "../include/scheduler.h"
+using namespace std;
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec/1e9;
+}
+
+// runs the scheduler on the confs in the current directory like main
+// does, and prints one line with the time every phase took and the
+// peak resident set size, so runs can be compared to a recorded baseline.
+int main(int argc, char* argv[]) {
+    size_t threads = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (string(argv[i]) == "--threads" && i+1 < argc) {
+            threads = atoi(argv[++i]);
+            if (threads == 0) {
+                threads = 1;
+            }
+        }
+    }
+
+    Scheduler scheduler(threads);
+    double start = now();
+
+    if (!scheduler.loadCourses("courses.conf")) {
+        cout << "Failed opening courses.conf." << endl;
+        return 1;
+    }
+    double courses_done = now();
+
+    if (!scheduler.loadStudents("students.conf")) {
+        cout << "Failed opening students.conf." << endl;
+        return 1;
+    }
+    double students_done = now();
+
+    scheduler.enroll();
+    double enroll_done = now();
+
+    if (!scheduler.printCourses("courses.out") 
+        || !scheduler.printStudents("students.out"))
+    {
+        cout << "Failed writing output." << endl;
+        return 1;
+    }
+    double print_done = now();
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    const Registry& registry = scheduler.getRegistry();
+    cout << fixed << setprecision(3)
+         << "students " << setw(9) << registry.getStudentCount()
+         << " sections " << setw(8) << registry.getCourseCount()
+         << " threads " << threads
+         << " | parse-courses " << setw(8) << courses_done - start << "s"
+         << " parse-students " << setw(8) << students_done - courses_done << "s"
+         << " enroll " << setw(8) << enroll_done - students_done << "s"
+         << " print " << setw(8) << print_done - enroll_done << "s"
+         << " total " << setw(8) << print_done - start << "s"
+         << " | peak-rss " << usage.ru_maxrss << "KB" << endl;
+
+    return 0;
+}
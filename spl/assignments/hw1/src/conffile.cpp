@@ -0,0 +1,199 @@
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../include/conffile.h"
+using namespace std;
+
+ConfFile::ConfFile():
+    _data(0),
+    _size(0),
+    _pos(0),
+    _fd(-1),
+    _eof(false),
+    _failed(false),
+    _buffer()
+{
+}
+
+ConfFile::~ConfFile() {
+    close();
+}
+
+bool ConfFile::open(const string& filename) {
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        ::close(fd);
+        return false;
+    }
+
+    _size = st.st_size;
+    if (_size > 0) {
+        void* data = mmap(0, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            ::close(fd);
+            _size = 0;
+            return false;
+        }
+
+        // we only walk the file front to back once.
+        madvise(data, _size, MADV_SEQUENTIAL);
+        _data = static_cast<const char*>(data);
+    } else {
+        // mmap refuses empty mappings, an empty file simply has no lines.
+        _data = "";
+    }
+
+    // the mapping stays valid after the descriptor is closed.
+    ::close(fd);
+    return true;
+}
+
+bool ConfFile::open(int fd) {
+    close();
+    if (fd < 0) {
+        return false;
+    }
+
+    _fd = fd;
+    _eof = false;
+    _failed = false;
+    _buffer.resize(BUFFER_SIZE);
+    _data = &_buffer[0];
+    return true;
+}
+
+void ConfFile::close() {
+    if (_fd < 0 && _data != 0 && _size > 0) {
+        munmap(const_cast<char*>(_data), _size);
+    }
+
+    _data = 0;
+    _size = 0;
+    _pos = 0;
+    _fd = -1;
+    _buffer.clear();
+}
+
+bool ConfFile::fill() {
+    // a mapped file is all there from the start
+    if (_fd < 0 || _eof) {
+        return false;
+    }
+
+    // keep the unread part of the line, and grow the buffer when a
+    // single line fills all of it.
+    size_t left = _size - _pos;
+    memmove(&_buffer[0], &_buffer[_pos], left);
+    _pos = 0;
+    _size = left;
+    if (_size == _buffer.size()) {
+        _buffer.resize(_buffer.size() * 2);
+    }
+    _data = &_buffer[0];
+
+    ssize_t got;
+    do {
+        got = read(_fd, &_buffer[_size], _buffer.size() - _size);
+    } while (got < 0 && errno == EINTR);
+
+    if (got <= 0) {
+        // a failed read is not a short file, remember which one it was
+        _failed = (got < 0);
+        _eof = true;
+        return false;
+    }
+
+    _size += got;
+    return true;
+}
+
+bool ConfFile::readLine(string_view& line) {
+    if (_data == 0) {
+        return false;
+    }
+
+    const char* end = 0;
+    do {
+        end = static_cast<const char*>(memchr(_data + _pos, '\n', _size - _pos));
+    } while (end == 0 && fill());
+
+    if (_pos >= _size) {
+        return false;
+    }
+
+    const char* start = _data + _pos;
+    if (end == 0) {
+        // last line has no trailing newline
+        end = _data + _size;
+        _pos = _size;
+    } else {
+        _pos = (end - _data) + 1;
+    }
+
+    line = string_view(start, end - start);
+    return true;
+}
+
+bool ConfFile::failed() const {
+    return _failed;
+}
+
+bool ConfFile::readFields(Fields& fields, char separator) {
+    string_view line;
+    if (!readLine(line)) {
+        return false;
+    }
+
+    split(line, separator, fields);
+    return true;
+}
+
+void ConfFile::split(string_view line, char separator, Fields& fields) {
+    fields.clear();
+
+    size_t start = 0;
+    for (size_t i = 0; i < line.size(); ++i) {
+        if (line[i] == separator) {
+            fields.push_back(line.substr(start, i - start));
+            start = i + 1;
+        }
+    }
+
+    // like before, an empty trailing field is dropped.
+    if (start < line.size()) {
+        fields.push_back(line.substr(start));
+    }
+}
+
+int ConfFile::toInt(string_view str) {
+    // same rules as atoi(), without needing a terminated copy.
+    size_t i = 0;
+    while (i < str.size() && (str[i] == ' ' || (str[i] >= '\t' && str[i] <= '\r'))) {
+        ++i;
+    }
+
+    bool negative = false;
+    if (i < str.size() && (str[i] == '-' || str[i] == '+')) {
+        negative = (str[i] == '-');
+        ++i;
+    }
+
+    int value = 0;
+    for ( ; i < str.size() && str[i] >= '0' && str[i] <= '9'; ++i) {
+        value = value*10 + (str[i] - '0');
+    }
+
+    return negative ? -value : value;
+}
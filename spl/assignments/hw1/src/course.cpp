@@ -1,47 +1,93 @@
-#include <string>
-#include <iostream>
-#include <vector>
 #include "../include/course.h"
 #include "../include/student.h"
+#include "../include/seat.h"
+#include "../include/registry.h"
+#include "../include/outputfile.h"
 using namespace std;
 
-Course::Course(int weekday, string course_id, int room):
+Course::Course(int weekday, Handle course_index, int room):
     _weekday(weekday),
-    _course_id(course_id),
+    _course_index(course_index),
+    _capacity(room),
     _room(room),
-    _students()
+    _first_seat(NO_HANDLE),
+    _last_seat(NO_HANDLE)
 {
     // constructor
 }
 
-bool Course::addStudent(Student* student) {
+bool Course::takeSeat() {
     if (_room <= 0) {
         // no more room in this course
         return false;
     }
 
-    _students.push_back(student);
-    student->addCourse(this);
     _room--;
     return true;
 }
 
-void Course::print(string filename) {
-    ofstream stream;
-    
-    stream.open(filename.c_str(), ios::app);
-    stream << _weekday << " " << _course_id << endl;
-    for (size_t i = 0; i < _students.size(); ++i) {
-        stream << _students[i]->getStudentId() << endl;
+void Course::freeSeat() {
+    _room++;
+}
+
+void Course::addSeat(Handle seat, Seats& seats) {
+    // the roster is kept in enrollment order
+    seats[seat].prev_in_course = _last_seat;
+    seats[seat].next_in_course = NO_HANDLE;
+    if (_last_seat == NO_HANDLE) {
+        _first_seat = seat;
+    } else {
+        seats[_last_seat].next_in_course = seat;
+    }
+
+    _last_seat = seat;
+}
+
+void Course::removeSeat(Handle seat, Seats& seats) {
+    // the room stays taken, whoever dropped the seat decides who gets it
+    Handle prev = seats[seat].prev_in_course;
+    Handle next = seats[seat].next_in_course;
+    if (prev == NO_HANDLE) {
+        _first_seat = next;
+    } else {
+        seats[prev].next_in_course = next;
     }
 
-    stream.close();
+    if (next == NO_HANDLE) {
+        _last_seat = prev;
+    } else {
+        seats[next].prev_in_course = prev;
+    }
+}
+
+void Course::print(OutputFile& output, const Registry& registry) const {
+    output << _weekday << ' ' << registry.getCourseId(_course_index) << '\n';
+    for (Handle seat = _first_seat; seat != NO_HANDLE; 
+         seat = registry.getSeat(seat).next_in_course)
+    {
+        const Student& student = registry.getStudent(registry.getSeat(seat).student);
+        output << registry.getStudentId(student.getStudentId()) << '\n';
+    }
+}
+
+void Course::getSeats(Handles& seats, const Registry& registry) const {
+    // roster order
+    seats.clear();
+    for (Handle seat = _first_seat; seat != NO_HANDLE; 
+         seat = registry.getSeat(seat).next_in_course)
+    {
+        seats.push_back(seat);
+    }
 }
 
 int Course::getWeekday() const {
     return _weekday;
 }
 
-string Course::getCourseId() const {
-    return _course_id;
+Handle Course::getCourseIndex() const {
+    return _course_index;
+}
+
+int Course::getCapacity() const {
+    return _capacity;
 }
@@ -0,0 +1,286 @@
+#include <string>
+#include <string_view>
+#include <vector>
+#include <charconv>
+#include <system_error>
+#include "../include/eventenrollment.h"
+#include "../include/registry.h"
+#include "../include/conffile.h"
+using namespace std;
+
+EventEnrollment::EventEnrollment(Registry& registry):
+    _registry(registry),
+    _holdings(),
+    _holding_count(0),
+    _waiting(),
+    _free_waiting(),
+    _first_waiting(),
+    _last_waiting(),
+    _next_seat()
+{
+}
+
+uint64_t EventEnrollment::key(Handle student, Handle course_index) {
+    return (static_cast<uint64_t>(student) << 32) | course_index;
+}
+
+size_t EventEnrollment::homeOf(uint64_t key) const {
+    // fibonacci hashing, the low bits of a key alone are too regular
+    return ((key * 0x9E3779B97F4A7C15ull) >> 32) & (_holdings.size() - 1);
+}
+
+size_t EventEnrollment::findHolding(uint64_t key) const {
+    // either the slot holding key, or the empty slot it would go to.
+    size_t mask = _holdings.size() - 1;
+    size_t slot = homeOf(key);
+    while (_holdings[slot].key != NO_KEY && _holdings[slot].key != key) {
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+EventEnrollment::Holding& EventEnrollment::addHolding(uint64_t key) {
+    // keep the table at most half full so probe runs stay short.
+    if (2*(_holding_count + 1) > _holdings.size()) {
+        vector<Holding> old;
+        old.swap(_holdings);
+
+        Holding empty = { NO_KEY, NO_HANDLE, false };
+        _holdings.assign(2*old.size(), empty);
+        for (size_t i = 0; i < old.size(); ++i) {
+            if (old[i].key != NO_KEY) {
+                _holdings[findHolding(old[i].key)] = old[i];
+            }
+        }
+    }
+
+    Holding& holding = _holdings[findHolding(key)];
+    holding.key = key;
+    _holding_count++;
+    return holding;
+}
+
+void EventEnrollment::removeHolding(size_t slot) {
+    // no tombstones: pull back every later entry of the probe run that
+    // may sit in the slot being emptied.
+    size_t mask = _holdings.size() - 1;
+    size_t next = slot;
+    for (;;) {
+        next = (next + 1) & mask;
+        if (_holdings[next].key == NO_KEY) {
+            break;
+        }
+
+        size_t home = homeOf(_holdings[next].key);
+        if (((next - home) & mask) >= ((next - slot) & mask)) {
+            _holdings[slot] = _holdings[next];
+            slot = next;
+        }
+    }
+
+    _holdings[slot].key = NO_KEY;
+    _holding_count--;
+}
+
+void EventEnrollment::indexSeats() {
+    // the seats handed out before the first event
+    size_t course_ids = _registry.getCourseIdCount();
+    _first_waiting.assign(course_ids, NO_HANDLE);
+    _last_waiting.assign(course_ids, NO_HANDLE);
+    _next_seat.clear();
+
+    Holding empty = { NO_KEY, NO_HANDLE, false };
+    _holdings.assign(1024, empty);
+    _holding_count = 0;
+    Handles seats;
+    for (Handle course = 0; course < _registry.getCourseCount(); ++course) {
+        Handle course_index = _registry.getCourse(course).getCourseIndex();
+        _registry.getCourse(course).getSeats(seats, _registry);
+        for (size_t i = 0; i < seats.size(); ++i) {
+            uint64_t held = key(_registry.getSeat(seats[i]).student, course_index);
+            setNextSeat(seats[i], NO_HANDLE);
+            size_t slot = findHolding(held);
+            if (_holdings[slot].key != held) {
+                Holding& holding = addHolding(held);
+                holding.handle = seats[i];
+                holding.waiting = false;
+                continue;
+            }
+
+            // the course id was asked for twice, the seat goes last in
+            // the holding's chain
+            Handle last = _holdings[slot].handle;
+            while (_next_seat[last] != NO_HANDLE) {
+                last = _next_seat[last];
+            }
+            _next_seat[last] = seats[i];
+        }
+    }
+}
+
+void EventEnrollment::setNextSeat(Handle seat, Handle next) {
+    // seat handles are recycled, so the table only ever grows
+    if (seat >= _next_seat.size()) {
+        _next_seat.resize(seat + 1, NO_HANDLE);
+    }
+    _next_seat[seat] = next;
+}
+
+bool EventEnrollment::apply(const string& filename) {
+    ConfFile file;
+    Fields tokens;
+
+    if (!file.open(filename)) {
+        return false;
+    }
+    indexSeats();
+
+    long long last_time = 0;
+    while (file.readFields(tokens, ',')) {
+        // data: TIME,+|-,STUD-ID,COURSE-ID
+        if (tokens.size() < 4 || tokens[1].size() != 1) {
+            continue;
+        }
+
+        // the whole field has to be a number that fits, garbage or an
+        // overflow would silently reorder the events
+        long long time = 0;
+        const char* end = tokens[0].data() + tokens[0].size();
+        from_chars_result parsed = from_chars(tokens[0].data(), end, time);
+        if (parsed.ec != errc() || parsed.ptr != end) {
+            continue;
+        }
+
+        if (time < last_time) {
+            // out of order, the waitlists would not mean a thing
+            return false;
+        }
+        last_time = time;
+
+        Handle course_index = _registry.findCourseIndex(tokens[3]);
+        if (course_index == NO_HANDLE) {
+            // nobody teaches this course
+            continue;
+        }
+
+        Handle student = _registry.findStudent(tokens[2]);
+        if (tokens[1][0] == '+') {
+            if (student == NO_HANDLE) {
+                student = _registry.addStudent(tokens[2]);
+            }
+            enroll(student, course_index);
+        } else if (tokens[1][0] == '-' && student != NO_HANDLE) {
+            drop(student, course_index);
+        }
+    }
+
+    return true;
+}
+
+void EventEnrollment::enroll(Handle student, Handle course_index) {
+    uint64_t held = key(student, course_index);
+    if (_holdings[findHolding(held)].key == held) {
+        // already sitting or waiting
+        return;
+    }
+
+    const Handles& sections = _registry.getSections(course_index);
+    for (size_t j = 0; j < sections.size(); ++j) {
+        if (_registry.getCourse(sections[j]).takeSeat()) {
+            Handle seat = _registry.addSeat(student, sections[j]);
+            setNextSeat(seat, NO_HANDLE);
+            Holding& holding = addHolding(held);
+            holding.handle = seat;
+            holding.waiting = false;
+            return;
+        }
+    }
+
+    // every section is full, wait for the first seat any of them frees
+    Handle waiting = wait(student, course_index);
+    Holding& holding = addHolding(held);
+    holding.handle = waiting;
+    holding.waiting = true;
+}
+
+void EventEnrollment::drop(Handle student, Handle course_index) {
+    uint64_t held = key(student, course_index);
+    size_t slot = findHolding(held);
+    if (_holdings[slot].key != held) {
+        return;
+    }
+
+    Handle handle = _holdings[slot].handle;
+    bool waiting = _holdings[slot].waiting;
+    removeHolding(slot);
+
+    if (waiting) {
+        unwait(handle);
+        return;
+    }
+
+    // every seat of the holding goes, in the order they were chained
+    while (handle != NO_HANDLE) {
+        Handle next = _next_seat[handle];
+        Handle course = _registry.getSeat(handle).course;
+        _registry.removeSeat(handle);
+        freeSeat(course, course_index);
+        handle = next;
+    }
+}
+
+void EventEnrollment::freeSeat(Handle course, Handle course_index) {
+    Handle head = _first_waiting[course_index];
+    if (head == NO_HANDLE) {
+        _registry.getCourse(course).freeSeat();
+        return;
+    }
+
+    // the seat is still taken, it just changes hands
+    Handle promoted = _waiting[head].student;
+    unwait(head);
+    Handle seat = _registry.addSeat(promoted, course);
+    setNextSeat(seat, NO_HANDLE);
+    Holding& promoted_holding = _holdings[findHolding(key(promoted, course_index))];
+    promoted_holding.handle = seat;
+    promoted_holding.waiting = false;
+}
+
+Handle EventEnrollment::wait(Handle student, Handle course_index) {
+    Waiting record = { student, course_index, _last_waiting[course_index], NO_HANDLE };
+    Handle waiting;
+    if (_free_waiting.empty()) {
+        waiting = _waiting.size();
+        _waiting.push_back(record);
+    } else {
+        waiting = _free_waiting.back();
+        _free_waiting.pop_back();
+        _waiting[waiting] = record;
+    }
+
+    if (_last_waiting[course_index] == NO_HANDLE) {
+        _first_waiting[course_index] = waiting;
+    } else {
+        _waiting[_last_waiting[course_index]].next = waiting;
+    }
+    _last_waiting[course_index] = waiting;
+    return waiting;
+}
+
+void EventEnrollment::unwait(Handle waiting) {
+    Waiting& record = _waiting[waiting];
+    if (record.prev == NO_HANDLE) {
+        _first_waiting[record.course_index] = record.next;
+    } else {
+        _waiting[record.prev].next = record.next;
+    }
+
+    if (record.next == NO_HANDLE) {
+        _last_waiting[record.course_index] = record.prev;
+    } else {
+        _waiting[record.next].prev = record.prev;
+    }
+
+    _free_waiting.push_back(waiting);
+}
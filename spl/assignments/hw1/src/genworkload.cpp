@@ -0,0 +1,73 @@
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <random>
+#include "../include/outputfile.h"
+using namespace std;
+
+// writes a synthetic courses.conf/students.conf pair to the current
+// directory:
+//  SECTIONS  sections, about three per course id, on weekdays 1-7
+//  STUDENTS  students
+//  REQUESTS  average number of courses every student asks for
+//  PRESSURE  requested seats per available seat (>1 means not everybody
+//            gets what they asked for)
+int main(int argc, char* argv[]) {
+    if (argc < 5) {
+        cout << "Usage: genworkload SECTIONS STUDENTS REQUESTS PRESSURE [SEED]" << endl;
+        return 1;
+    }
+
+    long sections = atol(argv[1]);
+    long students = atol(argv[2]);
+    long requests = atol(argv[3]);
+    double pressure = atof(argv[4]);
+    unsigned seed = (argc > 5) ? atoi(argv[5]) : 1;
+    if (sections < 1 || students < 0 || requests < 0 || pressure <= 0) {
+        cout << "Invalid workload parameters." << endl;
+        return 1;
+    }
+
+    mt19937 random(seed);
+    long course_ids = (sections >= 3) ? sections/3 : 1;
+    double seats = students*requests/pressure;
+    long room = static_cast<long>(seats/sections + 0.5);
+
+    OutputFile output;
+    if (!output.open("courses.conf")) {
+        cout << "Failed opening courses.conf." << endl;
+        return 1;
+    }
+    uniform_int_distribution<int> weekday(1, 7);
+    uniform_int_distribution<long> course_id(0, course_ids - 1);
+    uniform_int_distribution<long> section_room(0, 2*room);
+    for (long i = 0; i < sections; ++i) {
+        // every course id gets at least one section
+        long id = (i < course_ids) ? i : course_id(random);
+        output << weekday(random) << ",C" << static_cast<int>(id) << ',';
+        output << static_cast<int>(section_room(random)) << '\n';
+    }
+    if (!output.close()) {
+        cout << "Failed writing courses.conf." << endl;
+        return 1;
+    }
+
+    if (!output.open("students.conf")) {
+        cout << "Failed opening students.conf." << endl;
+        return 1;
+    }
+    uniform_int_distribution<long> request_count(0, 2*requests);
+    for (long i = 0; i < students; ++i) {
+        output << 'S' << static_cast<int>(i);
+        for (long n = request_count(random); n > 0; --n) {
+            output << ",C" << static_cast<int>(course_id(random));
+        }
+        output << '\n';
+    }
+    if (!output.close()) {
+        cout << "Failed writing students.conf." << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include "../include/snapshot.h"
+#include "../include/outputfile.h"
+using namespace std;
+
+// answers "student ID" and "course ID" queries from a snapshot written
+// by matrixU --snapshot, printing the same blocks as students.out and
+// courses.out. the query comes from the command line or, without one,
+// one per line from stdin.
+static bool query(const Snapshot& snapshot, OutputFile& output, 
+                  string_view kind, string_view id)
+{
+    bool found = false;
+    if (kind == "student") {
+        found = snapshot.printStudent(output, id);
+    } else if (kind == "course") {
+        found = snapshot.printCourse(output, id);
+    } else {
+        output << "Unknown query: " << kind << '\n';
+        return false;
+    }
+
+    if (!found) {
+        output << "No " << kind << ' ' << id << '\n';
+    }
+
+    return found;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 2 && argc != 4) {
+        cout << "Usage: lookup SNAPSHOT [student ID | course ID]" << endl;
+        return 1;
+    }
+
+    Snapshot snapshot;
+    if (!snapshot.open(argv[1])) {
+        cout << "Failed opening " << argv[1] << "." << endl;
+        return 1;
+    }
+
+    OutputFile output;
+    output.open(STDOUT_FILENO);
+
+    if (argc == 4) {
+        bool found = query(snapshot, output, argv[2], argv[3]);
+        output.close();
+        return found ? 0 : 1;
+    }
+
+    string line;
+    while (getline(cin, line)) {
+        size_t space = line.find(' ');
+        if (space == string::npos) {
+            output << "Usage: student ID | course ID\n";
+        } else {
+            query(snapshot, output, string_view(line).substr(0, space), 
+                  string_view(line).substr(space + 1));
+        }
+
+        // answer before waiting for the next query
+        output.flush();
+    }
+
+    output.close();
+    return 0;
+}
@@ -1,111 +1,190 @@
 #include <iostream>
-#include <fstream>
-#include <vector>
 #include <string>
 #include <cstdlib>
-#include "../include/typedef.h"
-#include "../include/student.h"
-#include "../include/course.h"
+#include <unistd.h>
+#include "../include/scheduler.h"
+#include "../include/stats.h"
 using namespace std;
 
-vector<string> str_split(string str, char separator) {
-	vector<string> words;
-	string word = ""; 
-    string::iterator it;
-	for (it = str.begin(); it < str.end(); ++it) {
-		if (*it == separator) {
-			words.push_back(word);
-			word = "";
-		} else {
-			word = word + *it;
-		}
-	}
-
-	if (word != "") words.push_back(word);
-	
-	return words;
-}
+struct Options {
+    size_t threads;
+    bool match;
+    bool stream;
+    bool stats;
+    string events;
+    string state;
+    string delta;
+    string snapshot;
+};
 
-int main(int argc, char* argv[]) {
-    ifstream file;
-    string data;
-    vector<string> tokens;
-    Courses courses;
-    Students students;
-
-    file.open("courses.conf");
-    if (!file.is_open()) {
+static int runStream(Scheduler& scheduler, Stats& stats) {
+    stats.startPhase("parse-courses");
+    if (!scheduler.loadCourses("courses.conf")) {
         cout << "Failed opening courses.conf." << endl;
         return 0;
     }
-    while (getline(file, data)) {
-        tokens = str_split(data, ',');
-        // data: WEEKDAY,COURSE-ID,SPACE
-        Course* course = new Course(*(tokens[0].c_str()) - '0', 
-                                    tokens[1], 
-                                    atoi(tokens[2].c_str()));
-        courses.push_back(course);
+
+    // students are enrolled and printed while they are read
+    stats.startPhase("parse-students");
+    if (!scheduler.streamStudents(STDIN_FILENO, "students.out")) {
+        cout << "Failed reading students.conf or writing students.out." << endl;
+        return 0;
     }
-    file.close();
 
-    file.open("students.conf");
-    if (!file.is_open()) {
-        cout << "Failed opening students.conf." << endl;
+    stats.startPhase("output");
+    if (!scheduler.printCourses("courses.out")) {
+        cout << "Failed writing courses.out." << endl;
         return 0;
     }
 
-    while (getline(file, data)) {
-        tokens = str_split(data, ',');
-
-        // data: STUD-ID,COURSE-ID1,COURSE-ID2,...,COURSE-IDN
-        Student* student = new Student(tokens[0]);
-        if (tokens.size() > 1) {
-            for (size_t i = 1; i < tokens.size(); ++i) {
-                for (size_t j = 0; j < courses.size(); ++j) {
-                    if (courses[j]->getCourseId() == tokens[i]) {
-                        if (courses[j]->addStudent(student)) {
-                            // we have found a room for this student
-                            // in the course he requested, so we are breaking
-                            // the search for room.
-                            // NOTE: we are not break;'ing when we find 
-                            // a matching course because there might be 
-                            // room in another day for this course.
-                            break;
-                        }
-                    }
-                }
-            }
+    return 0;
+}
+
+static int run(Scheduler& scheduler, const Options& options, Stats& stats) {
+    if (options.stream) {
+        return runStream(scheduler, stats);
+    }
+
+    if (!options.delta.empty()) {
+        stats.startPhase("parse-state");
+        if (!scheduler.loadState(options.state, options.delta)) {
+            cout << "Failed loading " << options.state << " and " << options.delta << "." << endl;
+            return 1;
+        }
+    } else {
+        stats.startPhase("parse-courses");
+        if (!scheduler.loadCourses("courses.conf")) {
+            cout << "Failed opening courses.conf." << endl;
+            return 0;
         }
 
-        students.push_back(student);
+        stats.startPhase("parse-students");
+        if (!scheduler.loadStudents("students.conf")) {
+            cout << "Failed opening students.conf." << endl;
+            return 0;
+        }
     }
-    
-    file.close();
 
-    // clean output files
-    ofstream output;
-    output.open("courses.out");
-    output.close();
-    output.open("students.out");
-    output.close();
+    stats.startPhase("enroll");
+    scheduler.enroll();
+
+    if (!options.events.empty()) {
+        stats.startPhase("events");
+        if (!scheduler.applyEvents(options.events)) {
+            cout << "Failed applying " << options.events << "." << endl;
+            return 1;
+        }
+    }
 
-    for (size_t i = 0; i < courses.size(); ++i) {
-        courses[i]->print("courses.out");
+    if (options.match) {
+        scheduler.printMatching(cout);
     }
 
-    for (size_t i = 0; i < students.size(); ++i) {
-        students[i]->print("students.out");
+    stats.startPhase("output");
+    if (!scheduler.printCourses("courses.out")) {
+        cout << "Failed writing courses.out." << endl;
+        return 0;
+    }
+
+    if (!scheduler.printStudents("students.out")) {
+        cout << "Failed writing students.out." << endl;
+        return 0;
     }
 
-    for (size_t i = 0; i < courses.size(); ++i) {
-        delete courses[i];
-        courses[i] = 0;
+    if (!options.snapshot.empty() && !scheduler.saveSnapshot(options.snapshot)) {
+        cout << "Failed writing " << options.snapshot << "." << endl;
+        return 1;
     }
 
-    for (size_t i = 0; i < students.size(); ++i) {
-        delete students[i];
-        students[i] = 0;
+    if (!options.state.empty() && !scheduler.saveState(options.state)) {
+        cout << "Failed writing " << options.state << "." << endl;
+        return 1;
     }
 
     return 0;
 }
+
+int main(int argc, char* argv[]) {
+    // --threads N: enroll course by course on N threads instead of
+    // student by student while reading students.conf.
+    // --state FILE: save the enrollment result to FILE after the run.
+    // --delta FILE: start from the --state file instead of the confs and
+    // only apply the students who joined or withdrew in FILE.
+    // --snapshot FILE: also write the result as a binary snapshot to FILE,
+    // for bin/lookup.
+    // --match: report how many seats the run filled against the most any
+    // assignment could fill (ties broken by arrival order, as always).
+    // --stream: read students.conf from stdin and write students.out while
+    // reading it, keeping only the course rosters in memory.
+    // --stats: print the time of every phase and what enrollment did as
+    // json once the run is over.
+    // --events FILE: after enrolling, replay the add/drop events in FILE,
+    // with a waitlist for every course id.
+    Options options = { 0, false, false, false, "", "", "", "" };
+    for (int i = 1; i < argc; ++i) {
+        string arg(argv[i]);
+        if (arg == "--threads" && i+1 < argc) {
+            options.threads = atoi(argv[++i]);
+            if (options.threads == 0) {
+                options.threads = 1;
+            }
+        } else if (arg == "--state" && i+1 < argc) {
+            options.state = argv[++i];
+        } else if (arg == "--delta" && i+1 < argc) {
+            options.delta = argv[++i];
+        } else if (arg == "--snapshot" && i+1 < argc) {
+            options.snapshot = argv[++i];
+        } else if (arg == "--match") {
+            options.match = true;
+        } else if (arg == "--stream") {
+            options.stream = true;
+        } else if (arg == "--stats") {
+            options.stats = true;
+        } else if (arg == "--events" && i+1 < argc) {
+            options.events = argv[++i];
+        }
+    }
+
+    if (!options.delta.empty() && options.state.empty()) {
+        cout << "--delta needs a --state file." << endl;
+        return 1;
+    }
+
+    if (!options.events.empty() && (!options.state.empty() || options.match)) {
+        // both describe the enrollment before the events
+        cout << "--events can't be used with --state or --match." << endl;
+        return 1;
+    }
+
+    if (options.stream) {
+        // students are gone once printed, nothing is left to save or report
+        if (!options.state.empty() || !options.snapshot.empty() || options.match
+            || !options.events.empty())
+        {
+            cout << "--stream can't be used with --state, --snapshot, --match or --events." << endl;
+            return 1;
+        }
+        options.threads = 0;
+    } else if ((!options.state.empty() || options.match) && options.threads == 0) {
+        // the state and the matching report need every request, which
+        // only the sharded run records
+        options.threads = 1;
+    }
+
+    Stats stats;
+    RunCounters counters;
+    int status;
+    {
+        Scheduler scheduler(options.threads);
+        status = run(scheduler, options, stats);
+        counters = scheduler.getCounters();
+        stats.startPhase("teardown");
+    }
+    stats.endPhase();
+
+    if (options.stats) {
+        stats.print(cout, options.threads, counters);
+    }
+
+    return status;
+}
@@ -0,0 +1,138 @@
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstring>
+#include <cerrno>
+#include <charconv>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../include/outputfile.h"
+using namespace std;
+
+OutputFile::OutputFile():
+    _fd(-1),
+    _owned(false),
+    _buffer(BUFFER_SIZE),
+    _used(0),
+    _written(0),
+    _failed(false)
+{
+}
+
+OutputFile::~OutputFile() {
+    close();
+}
+
+bool OutputFile::open(const string& filename) {
+    close();
+
+    // truncates, like the old "clean output files" step did.
+    _fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    _owned = true;
+    _failed = false;
+    return (_fd >= 0);
+}
+
+bool OutputFile::open(int fd) {
+    // an already open descriptor (stdout...), it is left open on close.
+    close();
+
+    _fd = fd;
+    _owned = false;
+    _failed = false;
+    return (_fd >= 0);
+}
+
+bool OutputFile::flush() {
+    writeAll(&_buffer[0], _used);
+
+    // whatever could not be written is dropped, there is nowhere to put
+    // it. _failed remembers it for close().
+    _used = 0;
+    return !_failed;
+}
+
+bool OutputFile::writeAll(const char* data, size_t size) {
+    if (_failed) {
+        return false;
+    }
+
+    while (size > 0) {
+        ssize_t written = ::write(_fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            _failed = true;
+            return false;
+        }
+
+        data += written;
+        size -= written;
+        _written += written;
+    }
+
+    return true;
+}
+
+bool OutputFile::close() {
+    if (_fd < 0) {
+        return true;
+    }
+
+    flush();
+    if (_owned && ::close(_fd) < 0) {
+        _failed = true;
+    }
+
+    // an earlier failed write counts as much as the last one
+    _fd = -1;
+    return !_failed;
+}
+
+OutputFile& OutputFile::operator<<(string_view str) {
+    if (_failed) {
+        return *this;
+    }
+
+    if (_used + str.size() > _buffer.size()) {
+        flush();
+        if (str.size() > _buffer.size()) {
+            // bigger than the whole buffer, no point in copying it.
+            writeAll(str.data(), str.size());
+            return *this;
+        }
+    }
+
+    memcpy(&_buffer[_used], str.data(), str.size());
+    _used += str.size();
+    return *this;
+}
+
+OutputFile& OutputFile::operator<<(char c) {
+    if (_failed) {
+        return *this;
+    }
+
+    if (_used == _buffer.size()) {
+        flush();
+    }
+
+    _buffer[_used++] = c;
+    return *this;
+}
+
+OutputFile& OutputFile::write(const void* data, size_t size) {
+    return (*this << string_view(static_cast<const char*>(data), size));
+}
+
+size_t OutputFile::getBytesWritten() const {
+    return _written;
+}
+
+OutputFile& OutputFile::operator<<(int num) {
+    char digits[16];
+    to_chars_result result = to_chars(digits, digits + sizeof(digits), num);
+    return (*this << string_view(digits, result.ptr - digits));
+}
@@ -0,0 +1,142 @@
+#include <string_view>
+#include <vector>
+#include "../include/registry.h"
+using namespace std;
+
+Registry::Registry():
+    _course_ids(),
+    _student_ids(),
+    _courses(),
+    _students(),
+    _seats(),
+    _sections(),
+    _student_by_id(),
+    _free_seats()
+{
+}
+
+Handle Registry::addCourse(int weekday, string_view course_id, int room) {
+    Handle course_index = _course_ids.intern(course_id);
+    if (course_index == _sections.size()) {
+        // first section of this course id
+        _sections.push_back(Handles());
+    }
+
+    Handle course = _courses.size();
+    _courses.push_back(Course(weekday, course_index, room));
+    _sections[course_index].push_back(course);
+    return course;
+}
+
+Handle Registry::addStudent(string_view student_id) {
+    Handle student = _students.size();
+    Handle id = _student_ids.intern(student_id);
+    if (id == _student_by_id.size()) {
+        _student_by_id.push_back(student);
+    }
+
+    _students.push_back(Student(id));
+    return student;
+}
+
+bool Registry::enroll(Handle student, Handle course) {
+    if (!_courses[course].takeSeat()) {
+        return false;
+    }
+
+    addSeat(student, course);
+    return true;
+}
+
+Handle Registry::addSeat(Handle student, Handle course) {
+    // the seat is already taken, just put it on the roster and timetable.
+    Seat record = { student, course, NO_HANDLE, NO_HANDLE, NO_HANDLE, NO_HANDLE };
+    Handle seat;
+    if (_free_seats.empty()) {
+        seat = _seats.size();
+        _seats.push_back(record);
+    } else {
+        seat = _free_seats.back();
+        _free_seats.pop_back();
+        _seats[seat] = record;
+    }
+
+    _courses[course].addSeat(seat, _seats);
+    _students[student].addSeat(seat, _courses[course].getWeekday(), _seats);
+    return seat;
+}
+
+void Registry::removeSeat(Handle seat) {
+    // off the roster and the timetable; the room is still taken.
+    Seat& record = _seats[seat];
+    Course& course = _courses[record.course];
+    course.removeSeat(seat, _seats);
+    _students[record.student].removeSeat(seat, course.getWeekday(), _seats);
+
+    record.student = NO_HANDLE;
+    record.course = NO_HANDLE;
+    _free_seats.push_back(seat);
+}
+
+Handle Registry::findStudent(string_view student_id) const {
+    Handle id = _student_ids.find(student_id);
+    return (id == NO_HANDLE) ? NO_HANDLE : _student_by_id[id];
+}
+
+Handle Registry::findCourseIndex(string_view course_id) const {
+    return _course_ids.find(course_id);
+}
+
+const Handles* Registry::findSections(string_view course_id) const {
+    Handle course_index = findCourseIndex(course_id);
+    if (course_index == NO_HANDLE) {
+        // nobody teaches this course
+        return 0;
+    }
+
+    return &_sections[course_index];
+}
+
+const Handles& Registry::getSections(Handle course_index) const {
+    return _sections[course_index];
+}
+
+size_t Registry::getCourseIdCount() const {
+    return _sections.size();
+}
+
+Course& Registry::getCourse(Handle course) {
+    return _courses[course];
+}
+
+const Course& Registry::getCourse(Handle course) const {
+    return _courses[course];
+}
+
+const Student& Registry::getStudent(Handle student) const {
+    return _students[student];
+}
+
+const Seat& Registry::getSeat(Handle seat) const {
+    return _seats[seat];
+}
+
+size_t Registry::getCourseCount() const {
+    return _courses.size();
+}
+
+size_t Registry::getStudentCount() const {
+    return _students.size();
+}
+
+size_t Registry::getSeatCount() const {
+    return _seats.size() - _free_seats.size();
+}
+
+string_view Registry::getCourseId(Handle course_index) const {
+    return _course_ids.get(course_index);
+}
+
+string_view Registry::getStudentId(Handle student_id) const {
+    return _student_ids.get(student_id);
+}
@@ -0,0 +1,428 @@
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdio>
+#include "../include/scheduler.h"
+#include "../include/conffile.h"
+#include "../include/outputfile.h"
+#include "../include/snapshot.h"
+#include "../include/eventenrollment.h"
+using namespace std;
+
+const char* const Scheduler::STATE_HEADER = "MATRIXU-STATE";
+
+Scheduler::Scheduler(size_t threads):
+    _threads(threads),
+    _registry(),
+    _sharded(_registry),
+    _counters(),
+    _bytes_written(0),
+    _first_queued(NO_HANDLE),
+    _queued_from(),
+    _queued()
+{
+}
+
+bool Scheduler::loadCourses(const string& filename) {
+    ConfFile file;
+    Fields tokens;
+
+    if (!file.open(filename)) {
+        return false;
+    }
+    while (file.readFields(tokens, ',')) {
+        // data: WEEKDAY,COURSE-ID,SPACE
+        if (tokens.size() < 3 || tokens[0].empty()
+            || tokens[0][0] < '0' || tokens[0][0] > '9')
+        {
+            continue;
+        }
+
+        _registry.addCourse(tokens[0][0] - '0', 
+                            tokens[1], 
+                            ConfFile::toInt(tokens[2]));
+    }
+
+    return true;
+}
+
+bool Scheduler::loadStudents(const string& filename) {
+    ConfFile file;
+    Fields tokens;
+
+    if (!file.open(filename)) {
+        return false;
+    }
+    while (file.readFields(tokens, ',')) {
+        // data: STUD-ID,COURSE-ID1,COURSE-ID2,...,COURSE-IDN
+        if (tokens.empty()) {
+            continue;
+        }
+
+        Handle student = _registry.addStudent(tokens[0]);
+        if (_threads > 0) {
+            // seats are handed out once all the requests are known
+            _sharded.addStudent(student, tokens);
+        } else {
+            queueStudent(student, tokens);
+        }
+    }
+
+    return true;
+}
+
+void Scheduler::queueStudent(Handle student, const Fields& tokens) {
+    // parsing only: the seats are handed out by enroll(), so the two can
+    // be timed apart
+    if (_first_queued == NO_HANDLE) {
+        _first_queued = student;
+    }
+
+    _queued_from.push_back(_queued.size());
+    for (size_t i = 1; i < tokens.size(); ++i) {
+        Handle course_index = _registry.findCourseIndex(tokens[i]);
+        _counters.requests++;
+        if (course_index == NO_HANDLE) {
+            _counters.unknown++;
+            continue;
+        }
+
+        _queued.push_back(course_index);
+    }
+}
+
+void Scheduler::enrollQueued() {
+    _queued_from.push_back(_queued.size());
+    for (size_t i = 0; i + 1 < _queued_from.size(); ++i) {
+        Handle student = _first_queued + i;
+        for (size_t k = _queued_from[i]; k < _queued_from[i+1]; ++k) {
+            const Handles& sections = _registry.getSections(_queued[k]);
+            size_t j = 0;
+            for ( ; j < sections.size(); ++j) {
+                if (_registry.enroll(student, sections[j])) {
+                    // we have found a room for this student
+                    // in the course they requested, so we are breaking
+                    // the search for room.
+                    // NOTE: sections are kept in courses.conf order,
+                    // so if this one is full there might still be
+                    // room in another day for this course.
+                    break;
+                }
+            }
+            countProbes(j, sections.size());
+        }
+    }
+
+    // done with them
+    _first_queued = NO_HANDLE;
+    Handles().swap(_queued_from);
+    Handles().swap(_queued);
+}
+
+bool Scheduler::streamStudents(int input, const string& filename) {
+    ConfFile file;
+    OutputFile output;
+    Fields tokens;
+    Handles courses;
+
+    if (_threads > 0 || !file.open(input) || !output.open(filename)) {
+        return false;
+    }
+    while (file.readFields(tokens, ',')) {
+        // data: STUD-ID,COURSE-ID1,COURSE-ID2,...,COURSE-IDN
+        if (tokens.empty()) {
+            continue;
+        }
+
+        takeSeats(tokens, courses);
+        if (courses.empty()) {
+            // no roster will ever print this student, forget them now
+            output << tokens[0] << '\n';
+            continue;
+        }
+
+        Handle student = _registry.addStudent(tokens[0]);
+        for (size_t i = 0; i < courses.size(); ++i) {
+            _registry.addSeat(student, courses[i]);
+        }
+        _registry.getStudent(student).print(output, _registry);
+    }
+
+    // what was read is still printed, but a read error is not the end
+    bool ok = output.close() && !file.failed();
+    _bytes_written += output.getBytesWritten();
+    return ok;
+}
+
+void Scheduler::takeSeats(const Fields& tokens, Handles& courses) {
+    // same search as enrollQueued(), for a student who isn't registered
+    courses.clear();
+    for (size_t i = 1; i < tokens.size(); ++i) {
+        const Handles* sections = _registry.findSections(tokens[i]);
+        _counters.requests++;
+        if (sections == 0) {
+            _counters.unknown++;
+            continue;
+        }
+
+        size_t j = 0;
+        for ( ; j < sections->size(); ++j) {
+            if (_registry.getCourse((*sections)[j]).takeSeat()) {
+                courses.push_back((*sections)[j]);
+                break;
+            }
+        }
+        countProbes(j, sections->size());
+    }
+}
+
+void Scheduler::countProbes(size_t seated_at, size_t sections) {
+    // the search stopped at the section with room, or ran past the last
+    if (seated_at < sections) {
+        _counters.probes += seated_at + 1;
+        _counters.granted++;
+    } else {
+        _counters.probes += sections;
+        _counters.rejected++;
+    }
+}
+
+bool Scheduler::loadState(const string& filename, const string& delta_filename) {
+    ConfFile delta;
+    ConfFile state;
+    Fields tokens;
+    string_view line;
+
+    // the state file can only be replayed on the sharded engine
+    if (_threads == 0 || !delta.open(delta_filename) || !state.open(filename)) {
+        return false;
+    }
+
+    // delta lines: +STUD-ID,COURSE-ID1,...,COURSE-IDN for a student who
+    // joined (after everybody else), -STUD-ID for every student with that
+    // id who withdrew, counting the ones joining earlier in the delta.
+    vector<string_view> joined;
+    vector<size_t> joined_at;
+    unordered_map<string_view, size_t> withdrawn_at;
+    for (size_t at = 0; delta.readLine(line); ++at) {
+        if (line.size() < 2) {
+            continue;
+        }
+
+        if (line[0] == '+') {
+            joined.push_back(line.substr(1));
+            joined_at.push_back(at);
+        } else if (line[0] == '-') {
+            withdrawn_at[line.substr(1)] = at;
+        }
+    }
+
+    if (!state.readFields(tokens, ',') || tokens.size() < 2 
+        || tokens[0] != STATE_HEADER || ConfFile::toInt(tokens[1]) != STATE_VERSION)
+    {
+        return false;
+    }
+
+    Handles course_indexes;
+    Handles granted;
+    while (state.readFields(tokens, ',')) {
+        if (tokens.size() >= 4 && tokens[0] == "C") {
+            // data: C,WEEKDAY,COURSE-ID,SPACE
+            // a weekday out of range would index past every timetable,
+            // and saveState() never writes a negative or huge space.
+            string_view weekday = tokens[1];
+            string_view space = tokens[3];
+            if (weekday.size() != 1 || weekday[0] < '0' || weekday[0] > '9'
+                || space.empty() || space.size() > 9
+                || space.find_first_not_of("0123456789") != string_view::npos)
+            {
+                return false;
+            }
+
+            _registry.addCourse(weekday[0] - '0', tokens[2], ConfFile::toInt(space));
+            continue;
+        }
+
+        if (tokens.size() < 2 || tokens[0] != "S") {
+            return false;
+        }
+
+        // data: S,STUD-ID,COURSE-INDEX:SECTION,...
+        course_indexes.clear();
+        granted.clear();
+        for (size_t i = 2; i < tokens.size(); ++i) {
+            size_t colon = tokens[i].find(':');
+            if (colon == string_view::npos) {
+                return false;
+            }
+
+            Handle course_index = ConfFile::toInt(tokens[i].substr(0, colon));
+            string_view section = tokens[i].substr(colon + 1);
+            if (course_index >= _registry.getCourseIdCount()) {
+                return false;
+            }
+
+            const Handles& sections = _registry.getSections(course_index);
+            Handle course = NO_HANDLE;
+            if (section != "-") {
+                size_t ordinal = ConfFile::toInt(section);
+                if (ordinal >= sections.size()) {
+                    return false;
+                }
+                course = sections[ordinal];
+            }
+
+            course_indexes.push_back(course_index);
+            granted.push_back(course);
+        }
+
+        if (withdrawn_at.count(tokens[1]) > 0) {
+            // the seats this student had are free again, so everybody
+            // after them in those course ids may end up elsewhere.
+            for (size_t i = 0; i < granted.size(); ++i) {
+                if (granted[i] != NO_HANDLE) {
+                    _sharded.markChanged(course_indexes[i]);
+                }
+            }
+            continue;
+        }
+
+        _sharded.addStudent(_registry.addStudent(tokens[1]), course_indexes, granted);
+    }
+
+    for (size_t i = 0; i < joined.size(); ++i) {
+        ConfFile::split(joined[i], ',', tokens);
+        if (tokens.empty()) {
+            continue;
+        }
+
+        unordered_map<string_view, size_t>::const_iterator withdrawn =
+            withdrawn_at.find(tokens[0]);
+        if (withdrawn != withdrawn_at.end() && withdrawn->second > joined_at[i]) {
+            // joined and left again within this delta
+            continue;
+        }
+
+        _sharded.addStudent(_registry.addStudent(tokens[0]), tokens);
+    }
+
+    return true;
+}
+
+void Scheduler::enroll() {
+    if (_threads > 0) {
+        _sharded.run(_threads);
+    } else {
+        enrollQueued();
+    }
+}
+
+bool Scheduler::applyEvents(const string& filename) {
+    EventEnrollment events(_registry);
+    return events.apply(filename);
+}
+
+bool Scheduler::printCourses(const string& filename) const {
+    OutputFile output;
+    if (!output.open(filename)) {
+        return false;
+    }
+    for (Handle course = 0; course < _registry.getCourseCount(); ++course) {
+        _registry.getCourse(course).print(output, _registry);
+    }
+
+    bool ok = output.close();
+    _bytes_written += output.getBytesWritten();
+    return ok;
+}
+
+bool Scheduler::printStudents(const string& filename) const {
+    OutputFile output;
+    if (!output.open(filename)) {
+        return false;
+    }
+    for (Handle student = 0; student < _registry.getStudentCount(); ++student) {
+        _registry.getStudent(student).print(output, _registry);
+    }
+
+    bool ok = output.close();
+    _bytes_written += output.getBytesWritten();
+    return ok;
+}
+
+bool Scheduler::saveState(const string& filename) const {
+    // written next to the old state and then moved over it, so a
+    // failed run never leaves a half written state behind.
+    string temp_filename = filename + ".tmp";
+    OutputFile output;
+    if (_threads == 0 || !output.open(temp_filename)) {
+        return false;
+    }
+
+    output << STATE_HEADER << ',' << STATE_VERSION << '\n';
+    for (Handle course = 0; course < _registry.getCourseCount(); ++course) {
+        // data: C,WEEKDAY,COURSE-ID,SPACE
+        const Course& section = _registry.getCourse(course);
+        output << "C," << section.getWeekday() << ',';
+        output << _registry.getCourseId(section.getCourseIndex()) << ',';
+        // a negative space (from courses.conf) seats nobody, like 0
+        output << max(section.getCapacity(), 0) << '\n';
+    }
+    _sharded.save(output);
+
+    bool ok = output.close();
+    _bytes_written += output.getBytesWritten();
+    if (!ok) {
+        remove(temp_filename.c_str());
+        return false;
+    }
+
+    return (rename(temp_filename.c_str(), filename.c_str()) == 0);
+}
+
+void Scheduler::printMatching(ostream& output) const {
+    // requests for a course id can take any seat of its sections and
+    // nothing else, so the request/seat graph falls apart into one
+    // complete bipartite graph per course id, whose maximum matching is
+    // min(requests, seats). first come first served only turns a request
+    // away once every section of its course id is full, so it always
+    // reaches that maximum; the arrival order only decides who sits.
+    size_t requests = 0;
+    size_t seats = 0;
+    size_t maximum = 0;
+    for (Handle course_index = 0; course_index < _registry.getCourseIdCount(); ++course_index) {
+        size_t capacity = 0;
+        const Handles& sections = _registry.getSections(course_index);
+        for (size_t j = 0; j < sections.size(); ++j) {
+            if (_registry.getCourse(sections[j]).getCapacity() > 0) {
+                capacity += _registry.getCourse(sections[j]).getCapacity();
+            }
+        }
+
+        size_t demand = _sharded.getRequestCount(course_index);
+        requests += demand;
+        seats += capacity;
+        maximum += (demand < capacity) ? demand : capacity;
+    }
+
+    size_t filled = _registry.getSeatCount();
+    output << "matching: " << requests << " requests, " << seats << " seats, "
+           << filled << " filled, " << maximum << " at most, "
+           << maximum - filled << " gained" << endl;
+}
+
+bool Scheduler::saveSnapshot(const string& filename) const {
+    return Snapshot::save(_registry, filename);
+}
+
+RunCounters Scheduler::getCounters() const {
+    RunCounters counters = (_threads > 0) ? _sharded.getCounters() : _counters;
+    counters.bytes_written = _bytes_written;
+    return counters;
+}
+
+const Registry& Scheduler::getRegistry() const {
+    return _registry;
+}
@@ -0,0 +1,186 @@
+#include <vector>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include "../include/shardedenrollment.h"
+#include "../include/registry.h"
+#include "../include/outputfile.h"
+using namespace std;
+
+ShardedEnrollment::ShardedEnrollment(Registry& registry):
+    _registry(registry),
+    _students(),
+    _first_slot(1, 0),
+    _shards(),
+    _changed(),
+    _requested(),
+    _granted(),
+    _replayed(),
+    _probes(),
+    _counters(),
+    _next_shard(0)
+{
+}
+
+void ShardedEnrollment::addStudent(Handle student, const Fields& tokens) {
+    // tokens: STUD-ID,COURSE-ID1,COURSE-ID2,...,COURSE-IDN
+    for (size_t i = 1; i < tokens.size(); ++i) {
+        Handle course_index = _registry.findCourseIndex(tokens[i]);
+        _counters.requests++;
+        if (course_index == NO_HANDLE) {
+            _counters.unknown++;
+            continue;
+        }
+
+        addRequest(course_index, NO_HANDLE, false);
+    }
+
+    _students.push_back(student);
+    _first_slot.push_back(_granted.size());
+}
+
+void ShardedEnrollment::addStudent(Handle student, const Handles& course_indexes,
+                                   const Handles& granted)
+{
+    for (size_t i = 0; i < course_indexes.size(); ++i) {
+        addRequest(course_indexes[i], granted[i], true);
+    }
+    _counters.requests += course_indexes.size();
+
+    _students.push_back(student);
+    _first_slot.push_back(_granted.size());
+}
+
+void ShardedEnrollment::addRequest(Handle course_index, Handle granted, bool replayed) {
+    if (_shards.size() < _registry.getCourseIdCount()) {
+        // courses are all loaded before the first student arrives
+        _shards.resize(_registry.getCourseIdCount());
+        _changed.resize(_registry.getCourseIdCount(), false);
+    }
+
+    _shards[course_index].push_back(_granted.size());
+    _requested.push_back(course_index);
+    _granted.push_back(granted);
+    _replayed.push_back(replayed);
+}
+
+void ShardedEnrollment::markChanged(Handle course_index) {
+    if (_changed.size() < _registry.getCourseIdCount()) {
+        _shards.resize(_registry.getCourseIdCount());
+        _changed.resize(_registry.getCourseIdCount(), false);
+    }
+
+    _changed[course_index] = true;
+}
+
+void ShardedEnrollment::run(size_t threads) {
+    _next_shard = 0;
+    _probes.assign(_shards.size(), 0);
+    if (threads <= 1) {
+        serveShards();
+    } else {
+        boost::thread_group workers;
+        for (size_t i = 0; i < threads; ++i) {
+            workers.create_thread(boost::bind(&ShardedEnrollment::serveShards, this));
+        }
+        workers.join_all();
+    }
+
+    // merge: every student gets the seats in the order they were asked for,
+    // just like the sequential run would have added them. rosters come out
+    // in arrival order too, since students are merged in that order.
+    _counters.granted = 0;
+    _counters.rejected = 0;
+    for (size_t i = 0; i < _students.size(); ++i) {
+        for (size_t slot = _first_slot[i]; slot < _first_slot[i+1]; ++slot) {
+            if (_granted[slot] != NO_HANDLE) {
+                _registry.addSeat(_students[i], _granted[slot]);
+                _counters.granted++;
+            } else {
+                _counters.rejected++;
+            }
+        }
+    }
+
+    _counters.probes = 0;
+    for (size_t course_index = 0; course_index < _probes.size(); ++course_index) {
+        _counters.probes += _probes[course_index];
+    }
+}
+
+void ShardedEnrollment::serveShards() {
+    for (;;) {
+        size_t course_index = _next_shard.fetch_add(1);
+        if (course_index >= _shards.size()) {
+            return;
+        }
+
+        serveShard(course_index);
+    }
+}
+
+void ShardedEnrollment::serveShard(Handle course_index) {
+    const Handles& sections = _registry.getSections(course_index);
+    const vector<size_t>& slots = _shards[course_index];
+    bool changed = _changed[course_index];
+    size_t probes = 0;
+
+    for (size_t i = 0; i < slots.size(); ++i) {
+        size_t slot = slots[i];
+        if (_replayed[slot] && !changed) {
+            // nothing before this request changed, so it ends up
+            // exactly where it did last time.
+            if (_granted[slot] != NO_HANDLE) {
+                _registry.getCourse(_granted[slot]).takeSeat();
+            }
+            continue;
+        }
+
+        _granted[slot] = NO_HANDLE;
+        for (size_t j = 0; j < sections.size(); ++j) {
+            probes++;
+            if (_registry.getCourse(sections[j]).takeSeat()) {
+                // every slot and section belongs to exactly one shard,
+                // so no locking.
+                _granted[slot] = sections[j];
+                break;
+            }
+        }
+    }
+
+    // once per shard, neighbouring shards may be served on other threads
+    _probes[course_index] = probes;
+}
+
+size_t ShardedEnrollment::getRequestCount(Handle course_index) const {
+    return (course_index < _shards.size()) ? _shards[course_index].size() : 0;
+}
+
+const RunCounters& ShardedEnrollment::getCounters() const {
+    return _counters;
+}
+
+void ShardedEnrollment::save(OutputFile& output) const {
+    // data: S,STUD-ID,COURSE-INDEX:SECTION,... with SECTION being the
+    // position among the course id's sections, or '-' if none had room.
+    Handles ordinal(_registry.getCourseCount());
+    for (Handle course_index = 0; course_index < _registry.getCourseIdCount(); ++course_index) {
+        const Handles& sections = _registry.getSections(course_index);
+        for (size_t j = 0; j < sections.size(); ++j) {
+            ordinal[sections[j]] = j;
+        }
+    }
+
+    for (size_t i = 0; i < _students.size(); ++i) {
+        const Student& student = _registry.getStudent(_students[i]);
+        output << "S," << _registry.getStudentId(student.getStudentId());
+        for (size_t slot = _first_slot[i]; slot < _first_slot[i+1]; ++slot) {
+            output << ',' << static_cast<int>(_requested[slot]) << ':';
+            if (_granted[slot] == NO_HANDLE) {
+                output << '-';
+            } else {
+                output << static_cast<int>(ordinal[_granted[slot]]);
+            }
+        }
+        output << '\n';
+    }
+}
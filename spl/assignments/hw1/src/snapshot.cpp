@@ -0,0 +1,463 @@
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../include/snapshot.h"
+#include "../include/registry.h"
+#include "../include/outputfile.h"
+using namespace std;
+
+const char Snapshot::MAGIC[8] = { 'M', 'X', 'U', 'S', 'N', 'A', 'P', '\0' };
+
+namespace {
+
+uint64_t align(uint64_t offset) {
+    return (offset + 7) & ~static_cast<uint64_t>(7);
+}
+
+// writes zeros up to the next table
+void padTo(OutputFile& output, uint64_t& at, uint64_t offset) {
+    for ( ; at < offset; ++at) {
+        output << '\0';
+    }
+}
+
+template <typename T>
+void put(OutputFile& output, uint64_t& at, const T& value) {
+    output.write(&value, sizeof(value));
+    at += sizeof(value);
+}
+
+// sorts handles by the id they stand for, equal ids keep their order
+class ByStudentId {
+    public:
+        ByStudentId(const Registry& registry): _registry(registry) { }
+        bool operator()(uint32_t a, uint32_t b) const {
+            return id(a) < id(b);
+        }
+
+    private:
+        string_view id(uint32_t student) const {
+            return _registry.getStudentId(_registry.getStudent(student).getStudentId());
+        }
+
+        const Registry& _registry;
+};
+
+// every value is a handle below limit
+template <typename T>
+bool allBelow(const T* values, uint64_t count, uint64_t limit) {
+    for (uint64_t i = 0; i < count; ++i) {
+        if (values[i] >= limit) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// count+1 starts of consecutive ranges, from 0 up to at most limit
+template <typename T>
+bool isRangeIndex(const T* first, uint64_t count, uint64_t limit) {
+    if (first[0] != 0 || first[count] > limit) {
+        return false;
+    }
+
+    for (uint64_t i = 0; i < count; ++i) {
+        if (first[i] > first[i+1]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+class ByCourseId {
+    public:
+        ByCourseId(const Registry& registry): _registry(registry) { }
+        bool operator()(uint32_t a, uint32_t b) const {
+            return _registry.getCourseId(a) < _registry.getCourseId(b);
+        }
+
+    private:
+        const Registry& _registry;
+};
+
+}
+
+Snapshot::Snapshot():
+    _data(0),
+    _size(0),
+    _header(0)
+{
+}
+
+Snapshot::~Snapshot() {
+    close();
+}
+
+bool Snapshot::save(const Registry& registry, const string& filename) {
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.student_count = registry.getStudentCount();
+    header.course_id_count = registry.getCourseIdCount();
+    header.section_count = registry.getCourseCount();
+    header.seat_count = registry.getSeatCount();
+
+    for (Handle student = 0; student < header.student_count; ++student) {
+        header.strings_size += 
+            registry.getStudentId(registry.getStudent(student).getStudentId()).size();
+    }
+    for (Handle course_index = 0; course_index < header.course_id_count; ++course_index) {
+        header.strings_size += registry.getCourseId(course_index).size();
+    }
+
+    header.strings = align(sizeof(header));
+    header.student_names = align(header.strings + header.strings_size);
+    header.student_order = align(header.student_names + 
+                                 header.student_count*sizeof(SnapshotName));
+    header.timetable_first = align(header.student_order + 
+                                   header.student_count*sizeof(uint32_t));
+    header.timetable = align(header.timetable_first + 
+                             (header.student_count + 1)*sizeof(uint64_t));
+    header.course_names = align(header.timetable + 
+                                header.seat_count*sizeof(SnapshotLine));
+    header.course_order = align(header.course_names + 
+                                header.course_id_count*sizeof(SnapshotName));
+    header.sections_first = align(header.course_order + 
+                                  header.course_id_count*sizeof(uint32_t));
+    header.sections = align(header.sections_first + 
+                            (header.course_id_count + 1)*sizeof(uint32_t));
+    header.section_lines = align(header.sections + 
+                                 header.section_count*sizeof(uint32_t));
+    header.roster_first = align(header.section_lines + 
+                                header.section_count*sizeof(SnapshotLine));
+    header.roster = align(header.roster_first + 
+                          (header.section_count + 1)*sizeof(uint64_t));
+
+    OutputFile output;
+    if (!output.open(filename)) {
+        return false;
+    }
+
+    uint64_t at = 0;
+    put(output, at, header);
+
+    // ids: students first, then course ids
+    padTo(output, at, header.strings);
+    for (Handle student = 0; student < header.student_count; ++student) {
+        string_view id = registry.getStudentId(registry.getStudent(student).getStudentId());
+        output << id;
+        at += id.size();
+    }
+    for (Handle course_index = 0; course_index < header.course_id_count; ++course_index) {
+        string_view id = registry.getCourseId(course_index);
+        output << id;
+        at += id.size();
+    }
+
+    uint64_t offset = 0;
+    padTo(output, at, header.student_names);
+    for (Handle student = 0; student < header.student_count; ++student) {
+        SnapshotName name = { offset, 0, 0 };
+        name.length = registry.getStudentId(registry.getStudent(student).getStudentId()).size();
+        put(output, at, name);
+        offset += name.length;
+    }
+
+    vector<uint32_t> order(header.student_count);
+    for (uint32_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    stable_sort(order.begin(), order.end(), ByStudentId(registry));
+    padTo(output, at, header.student_order);
+    for (size_t i = 0; i < order.size(); ++i) {
+        put(output, at, order[i]);
+    }
+
+    Handles seats;
+    uint64_t first = 0;
+    padTo(output, at, header.timetable_first);
+    for (Handle student = 0; student < header.student_count; ++student) {
+        put(output, at, first);
+        registry.getStudent(student).getSeats(seats, registry);
+        first += seats.size();
+    }
+    put(output, at, first);
+
+    padTo(output, at, header.timetable);
+    for (Handle student = 0; student < header.student_count; ++student) {
+        registry.getStudent(student).getSeats(seats, registry);
+        for (size_t i = 0; i < seats.size(); ++i) {
+            const Course& course = registry.getCourse(registry.getSeat(seats[i]).course);
+            SnapshotLine line = { static_cast<uint32_t>(course.getWeekday()), 
+                                  course.getCourseIndex() };
+            put(output, at, line);
+        }
+    }
+
+    padTo(output, at, header.course_names);
+    for (Handle course_index = 0; course_index < header.course_id_count; ++course_index) {
+        SnapshotName name = { offset, 0, 0 };
+        name.length = registry.getCourseId(course_index).size();
+        put(output, at, name);
+        offset += name.length;
+    }
+
+    order.resize(header.course_id_count);
+    for (uint32_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    sort(order.begin(), order.end(), ByCourseId(registry));
+    padTo(output, at, header.course_order);
+    for (size_t i = 0; i < order.size(); ++i) {
+        put(output, at, order[i]);
+    }
+
+    uint32_t section_first = 0;
+    padTo(output, at, header.sections_first);
+    for (Handle course_index = 0; course_index < header.course_id_count; ++course_index) {
+        put(output, at, section_first);
+        section_first += registry.getSections(course_index).size();
+    }
+    put(output, at, section_first);
+
+    padTo(output, at, header.sections);
+    for (Handle course_index = 0; course_index < header.course_id_count; ++course_index) {
+        const Handles& sections = registry.getSections(course_index);
+        for (size_t i = 0; i < sections.size(); ++i) {
+            put(output, at, sections[i]);
+        }
+    }
+
+    padTo(output, at, header.section_lines);
+    for (Handle course = 0; course < header.section_count; ++course) {
+        const Course& section = registry.getCourse(course);
+        SnapshotLine line = { static_cast<uint32_t>(section.getWeekday()), 
+                              section.getCourseIndex() };
+        put(output, at, line);
+    }
+
+    first = 0;
+    padTo(output, at, header.roster_first);
+    for (Handle course = 0; course < header.section_count; ++course) {
+        put(output, at, first);
+        registry.getCourse(course).getSeats(seats, registry);
+        first += seats.size();
+    }
+    put(output, at, first);
+
+    padTo(output, at, header.roster);
+    for (Handle course = 0; course < header.section_count; ++course) {
+        registry.getCourse(course).getSeats(seats, registry);
+        for (size_t i = 0; i < seats.size(); ++i) {
+            put(output, at, registry.getSeat(seats[i]).student);
+        }
+    }
+
+    return output.close();
+}
+
+bool Snapshot::open(const string& filename) {
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(SnapshotHeader)) {
+        ::close(fd);
+        return false;
+    }
+
+    void* data = mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+
+    _data = static_cast<const char*>(data);
+    _size = st.st_size;
+    _header = table<SnapshotHeader>(0);
+
+    if (!isValid()) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+bool Snapshot::isValid() const {
+    // lookups trust the tables, so whatever a truncated or corrupt file
+    // holds must not lead them outside the mapping: every table fits,
+    // and so does every name, handle and range in them.
+    const SnapshotHeader& h = *_header;
+    uint64_t students = h.student_count;
+    uint64_t course_ids = h.course_id_count;
+    uint64_t sections = h.section_count;
+    if (memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0 || h.version != VERSION
+        || !hasTable(h.strings, h.strings_size, 1)
+        || !hasTable(h.student_names, students, sizeof(SnapshotName))
+        || !hasTable(h.student_order, students, sizeof(uint32_t))
+        || !hasTable(h.timetable_first, students + 1, sizeof(uint64_t))
+        || !hasTable(h.timetable, h.seat_count, sizeof(SnapshotLine))
+        || !hasTable(h.course_names, course_ids, sizeof(SnapshotName))
+        || !hasTable(h.course_order, course_ids, sizeof(uint32_t))
+        || !hasTable(h.sections_first, course_ids + 1, sizeof(uint32_t))
+        || !hasTable(h.sections, sections, sizeof(uint32_t))
+        || !hasTable(h.section_lines, sections, sizeof(SnapshotLine))
+        || !hasTable(h.roster_first, sections + 1, sizeof(uint64_t))
+        || !hasTable(h.roster, h.seat_count, sizeof(uint32_t)))
+    {
+        return false;
+    }
+
+    if (!hasNames(h.student_names, h.student_count)
+        || !hasNames(h.course_names, h.course_id_count)
+        || !allBelow(table<uint32_t>(h.student_order), students, students)
+        || !allBelow(table<uint32_t>(h.course_order), course_ids, course_ids)
+        || !isRangeIndex(table<uint64_t>(h.timetable_first), students, h.seat_count)
+        || !isRangeIndex(table<uint32_t>(h.sections_first), course_ids, sections)
+        || !isRangeIndex(table<uint64_t>(h.roster_first), sections, h.seat_count)
+        || !allBelow(table<uint32_t>(h.sections), sections, sections)
+        || !allBelow(table<uint32_t>(h.roster), h.seat_count, students))
+    {
+        return false;
+    }
+
+    const SnapshotLine* timetable = table<SnapshotLine>(h.timetable);
+    for (uint64_t i = 0; i < h.seat_count; ++i) {
+        if (timetable[i].course_index >= course_ids) {
+            return false;
+        }
+    }
+
+    const SnapshotLine* section_lines = table<SnapshotLine>(h.section_lines);
+    for (uint64_t i = 0; i < sections; ++i) {
+        if (section_lines[i].course_index >= course_ids) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Snapshot::close() {
+    if (_data != 0) {
+        munmap(const_cast<char*>(_data), _size);
+    }
+
+    _data = 0;
+    _size = 0;
+    _header = 0;
+}
+
+bool Snapshot::printStudent(OutputFile& output, string_view student_id) const {
+    const SnapshotName* names = table<SnapshotName>(_header->student_names);
+    const uint32_t* order = table<uint32_t>(_header->student_order);
+    const uint64_t* first = table<uint64_t>(_header->timetable_first);
+    const SnapshotLine* timetable = table<SnapshotLine>(_header->timetable);
+    const SnapshotName* course_names = table<SnapshotName>(_header->course_names);
+
+    // students.out blocks of every student with this id
+    bool found = false;
+    for (size_t i = lowerBound(names, order, _header->student_count, student_id);
+         i < _header->student_count && name(names, order[i]) == student_id;
+         ++i)
+    {
+        uint32_t student = order[i];
+        output << student_id << '\n';
+        for (uint64_t j = first[student]; j < first[student+1]; ++j) {
+            output << static_cast<int>(timetable[j].weekday) << ' ';
+            output << name(course_names, timetable[j].course_index) << '\n';
+        }
+        found = true;
+    }
+
+    return found;
+}
+
+bool Snapshot::printCourse(OutputFile& output, string_view course_id) const {
+    const SnapshotName* names = table<SnapshotName>(_header->course_names);
+    const uint32_t* order = table<uint32_t>(_header->course_order);
+    const uint32_t* sections_first = table<uint32_t>(_header->sections_first);
+    const uint32_t* sections = table<uint32_t>(_header->sections);
+    const SnapshotLine* section_lines = table<SnapshotLine>(_header->section_lines);
+    const uint64_t* roster_first = table<uint64_t>(_header->roster_first);
+    const uint32_t* roster = table<uint32_t>(_header->roster);
+    const SnapshotName* student_names = table<SnapshotName>(_header->student_names);
+
+    size_t i = lowerBound(names, order, _header->course_id_count, course_id);
+    if (i == _header->course_id_count || name(names, order[i]) != course_id) {
+        return false;
+    }
+
+    // courses.out blocks of every section of this course id
+    uint32_t course_index = order[i];
+    for (uint32_t j = sections_first[course_index]; j < sections_first[course_index+1]; ++j) {
+        uint32_t section = sections[j];
+        output << static_cast<int>(section_lines[section].weekday) << ' ';
+        output << course_id << '\n';
+        for (uint64_t k = roster_first[section]; k < roster_first[section+1]; ++k) {
+            output << name(student_names, roster[k]) << '\n';
+        }
+    }
+
+    return true;
+}
+
+template <typename T>
+const T* Snapshot::table(uint64_t offset) const {
+    return reinterpret_cast<const T*>(_data + offset);
+}
+
+bool Snapshot::hasTable(uint64_t offset, uint64_t count, size_t size) const {
+    // tables are written 8 byte aligned, so they can be read in place
+    return (offset % 8 == 0 && offset <= _size && count <= (_size - offset)/size);
+}
+
+bool Snapshot::hasNames(uint64_t offset, uint32_t count) const {
+    const SnapshotName* names = table<SnapshotName>(offset);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (names[i].offset > _header->strings_size
+            || names[i].length > _header->strings_size - names[i].offset)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+string_view Snapshot::name(const SnapshotName* names, uint32_t handle) const {
+    const SnapshotName& entry = names[handle];
+    return string_view(table<char>(_header->strings) + entry.offset, entry.length);
+}
+
+size_t Snapshot::lowerBound(const SnapshotName* names, const uint32_t* order,
+                            uint32_t count, string_view id) const
+{
+    // first position in order whose id is not less than the given one
+    size_t low = 0;
+    size_t high = count;
+    while (low < high) {
+        size_t middle = low + (high - low)/2;
+        if (name(names, order[middle]) < id) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
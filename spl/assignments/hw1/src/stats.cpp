@@ -0,0 +1,71 @@
+#include <string>
+#include <vector>
+#include <ostream>
+#include <iomanip>
+#include <ctime>
+#include "../include/stats.h"
+using namespace std;
+
+Stats::Stats():
+    _phases(),
+    _running(false),
+    _wall_start(0),
+    _cpu_start(0)
+{
+}
+
+double Stats::wallTime() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec/1e9;
+}
+
+double Stats::cpuTime() {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec/1e9;
+}
+
+void Stats::startPhase(const string& name) {
+    // phases follow each other, starting one ends the last
+    endPhase();
+
+    Phase phase = { name, 0, 0 };
+    _phases.push_back(phase);
+    _running = true;
+    _wall_start = wallTime();
+    _cpu_start = cpuTime();
+}
+
+void Stats::endPhase() {
+    if (!_running) {
+        return;
+    }
+
+    _phases.back().wall = wallTime() - _wall_start;
+    _phases.back().cpu = cpuTime() - _cpu_start;
+    _running = false;
+}
+
+void Stats::print(ostream& output, size_t threads, const RunCounters& counters) const {
+    // phase names are ours, nothing in them needs escaping
+    double wall = 0;
+    double cpu = 0;
+    output << fixed << setprecision(6);
+    output << "{\"threads\": " << threads << ", \"phases\": [";
+    for (size_t i = 0; i < _phases.size(); ++i) {
+        output << (i > 0 ? ", " : "") << "{\"name\": \"" << _phases[i].name
+               << "\", \"wall\": " << _phases[i].wall
+               << ", \"cpu\": " << _phases[i].cpu << "}";
+        wall += _phases[i].wall;
+        cpu += _phases[i].cpu;
+    }
+    output << "], \"total\": {\"wall\": " << wall << ", \"cpu\": " << cpu << "}";
+
+    output << ", \"counters\": {\"requests\": " << counters.requests
+           << ", \"unknown\": " << counters.unknown
+           << ", \"probes\": " << counters.probes
+           << ", \"granted\": " << counters.granted
+           << ", \"rejected\": " << counters.rejected
+           << ", \"bytes_written\": " << counters.bytes_written << "}}" << endl;
+}
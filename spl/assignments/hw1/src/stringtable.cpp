@@ -0,0 +1,73 @@
+#include <string_view>
+#include <vector>
+#include <cstring>
+#include <functional>
+#include "../include/stringtable.h"
+using namespace std;
+
+StringTable::StringTable():
+    _arena(),
+    _strings(),
+    _slots()
+{
+    Slot empty = { 0, 0, NO_HANDLE };
+    _slots.assign(1024, empty);
+}
+
+Handle StringTable::intern(string_view str) {
+    size_t slot = slotOf(str);
+    if (_slots[slot].handle != NO_HANDLE) {
+        return _slots[slot].handle;
+    }
+
+    char* data = _arena.allocate(str.size());
+    memcpy(data, str.data(), str.size());
+
+    Handle handle = _strings.size();
+    _strings.push_back(string_view(data, str.size()));
+    Slot record = { data, static_cast<unsigned int>(str.size()), handle };
+    _slots[slot] = record;
+
+    // keep the table at most half full so probe runs stay short.
+    if (2*_strings.size() > _slots.size()) {
+        grow();
+    }
+
+    return handle;
+}
+
+Handle StringTable::find(string_view str) const {
+    return _slots[slotOf(str)].handle;
+}
+
+string_view StringTable::get(Handle handle) const {
+    return _strings[handle];
+}
+
+size_t StringTable::size() const {
+    return _strings.size();
+}
+
+size_t StringTable::slotOf(string_view str) const {
+    // either the slot holding str, or the empty slot it would go to.
+    size_t mask = _slots.size() - 1;
+    size_t slot = hash<string_view>()(str) & mask;
+    while (_slots[slot].handle != NO_HANDLE
+           && (_slots[slot].size != str.size()
+               || memcmp(_slots[slot].data, str.data(), str.size()) != 0))
+    {
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+void StringTable::grow() {
+    Slot empty = { 0, 0, NO_HANDLE };
+    _slots.assign(2*_slots.size(), empty);
+    for (Handle handle = 0; handle < _strings.size(); ++handle) {
+        Slot record = { _strings[handle].data(),
+                        static_cast<unsigned int>(_strings[handle].size()), handle };
+        _slots[slotOf(_strings[handle])] = record;
+    }
+}
@@ -1,39 +1,86 @@
-#include <string>
-#include <iostream>
-#include <vector>
 #include "../include/student.h"
 #include "../include/course.h"
+#include "../include/seat.h"
+#include "../include/registry.h"
+#include "../include/outputfile.h"
 using namespace std;
 
-Student::Student(string student_id):
+Student::Student(Handle student_id):
     _student_id(student_id),
-    _courses()
+    _last_seat()
 {
+    for (int day = 0; day < WEEKDAYS; ++day) {
+        _last_seat[day] = NO_HANDLE;
+    }
 }
 
-void Student::addCourse(Course* course) {
-    vector<Course*>::iterator iter;
-    for (iter = _courses.begin(); iter < _courses.end(); ++iter) {
-        if ((*iter)->getWeekday() > course->getWeekday()) {
-            break;
-        }
+void Student::addSeat(Handle seat, int weekday, Seats& seats) {
+    // the timetable is sorted by weekday, and a course goes after
+    // the ones already taken on the same day.
+    Handle& last = _last_seat[weekday];
+    if (last == NO_HANDLE) {
+        seats[seat].next_in_day = seat;
+        seats[seat].prev_in_day = seat;
+    } else {
+        Handle first = seats[last].next_in_day;
+        seats[seat].next_in_day = first;
+        seats[seat].prev_in_day = last;
+        seats[first].prev_in_day = seat;
+        seats[last].next_in_day = seat;
     }
 
-    _courses.insert(iter, course);
+    last = seat;
 }
 
-void Student::print(string filename) {
-    ofstream stream;
-    stream.open(filename.c_str(), ios::app);
-    stream << _student_id << endl;
-    for (size_t i = 0; i < _courses.size(); ++i) {
-        stream << _courses[i]->getWeekday() << " ";
-        stream << _courses[i]->getCourseId() << endl;
+void Student::removeSeat(Handle seat, int weekday, Seats& seats) {
+    Handle& last = _last_seat[weekday];
+    if (seats[seat].next_in_day == seat) {
+        // the only course that day
+        last = NO_HANDLE;
+        return;
+    }
+
+    Handle prev = seats[seat].prev_in_day;
+    Handle next = seats[seat].next_in_day;
+    seats[prev].next_in_day = next;
+    seats[next].prev_in_day = prev;
+    if (last == seat) {
+        last = prev;
     }
+}
+
+void Student::print(OutputFile& output, const Registry& registry) const {
+    output << registry.getStudentId(_student_id) << '\n';
+    for (int day = 0; day < WEEKDAYS; ++day) {
+        if (_last_seat[day] == NO_HANDLE) {
+            continue;
+        }
 
-    stream.close();
+        Handle seat = _last_seat[day];
+        do {
+            seat = registry.getSeat(seat).next_in_day;
+            const Course& course = registry.getCourse(registry.getSeat(seat).course);
+            output << day << ' ' << registry.getCourseId(course.getCourseIndex()) << '\n';
+        } while (seat != _last_seat[day]);
+    }
+}
+
+void Student::getSeats(Handles& seats, const Registry& registry) const {
+    // timetable order
+    seats.clear();
+    for (int day = 0; day < WEEKDAYS; ++day) {
+        if (_last_seat[day] == NO_HANDLE) {
+            continue;
+        }
+
+        Handle seat = _last_seat[day];
+        do {
+            seat = registry.getSeat(seat).next_in_day;
+            seats.push_back(seat);
+        } while (seat != _last_seat[day]);
+    }
 }
 
-string Student::getStudentId() const {
+Handle Student::getStudentId() const {
     return _student_id;
 }
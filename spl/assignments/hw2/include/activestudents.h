@@ -0,0 +1,29 @@
+#ifndef ACTIVESTUDENTS_H
+#define ACTIVESTUDENTS_H
+#include <vector>
+#include "typedef.h"
+#include "curriculum.h"
+
+// the students a semester has to visit, in the order of the students
+// vector, each with the curriculum of their dept. PG students the MALAG
+// denied never get in, and students who will never take a course again
+// are dropped between semesters, so a semester costs what is still
+// studying and not everybody ever admitted.
+class ActiveStudents {
+    public:
+        ActiveStudents(Students& students, const Curriculum& CS_curriculum,
+                       const Curriculum& PG_curriculum, bool malag);
+        size_t size() const { return _students.size(); };
+        Student* getStudent(size_t i) const { return _students[i]; };
+        const Curriculum& getCurriculum(size_t i) const { return *_curriculums[i]; };
+        // drops the students who are done, keeping the others' order
+        void update();
+
+    private:
+        ActiveStudents(const ActiveStudents&);
+        ActiveStudents& operator=(const ActiveStudents&);
+
+        Students _students;
+        std::vector<const Curriculum*> _curriculums;
+};
+#endif
@@ -0,0 +1,66 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "typedef.h"
+
+// a checkpoint is written between two semesters: a header, then one
+// record per student in the sorted students order, every record
+// followed by its passed courses as words of bits and by the course
+// indexes of its pending dept courses and electives. numbers are native
+// endian. the draws are keyed by the seed and the semester, so the seed
+// and the next semester are all the random state there is.
+struct CheckpointHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t semester;      // the next semester to run
+    uint64_t seed;
+    uint64_t log_size;      // bytes of the log written before it
+    uint32_t student_count;
+    uint32_t course_count;
+    uint8_t malag;
+    uint8_t binary_log;
+    uint8_t unused[6];
+};
+
+struct ProgressRecord {
+    uint32_t student;
+    uint32_t current_semester;
+    uint32_t electives_wanted;
+    uint32_t passed_count;
+    uint32_t semester_course_count;
+    uint32_t elective_course_count;
+};
+
+// what a student has done so far, and what is still left to do
+struct StudentProgress {
+    uint32_t current_semester;
+    uint32_t electives_wanted;
+    uint32_t passed_count;
+    std::vector<uint64_t> passed;
+    std::vector<uint32_t> semester_courses;
+    std::vector<uint32_t> elective_courses;
+
+    StudentProgress():
+        current_semester(0),
+        electives_wanted(0),
+        passed_count(0),
+        passed(),
+        semester_courses(),
+        elective_courses()
+    {
+    }
+};
+
+extern const char CHECKPOINT_MAGIC[8];
+const uint32_t CHECKPOINT_VERSION = 1;
+
+// written to a temporary file first, a crash never leaves half of one.
+bool saveCheckpoint(const std::string& filename, const CheckpointHeader& header,
+                    Students& students);
+bool readCheckpointHeader(const std::string& filename, CheckpointHeader& header);
+// fails unless the checkpoint is of the same students and courses.
+bool loadCheckpoint(const std::string& filename, Students& students,
+                    Courses& all_courses);
+#endif
@@ -0,0 +1,30 @@
+#ifndef CONFFILE_H
+#define CONFFILE_H
+#include <string>
+#include <string_view>
+#include "typedef.h"
+
+// read-only, memory mapped configuration file.
+// lines and fields are views into the mapping, so they are only valid
+// while the file is open; copy whatever has to outlive it.
+class ConfFile {
+    public:
+        ConfFile();
+        ~ConfFile();
+        bool open(const std::string& filename);
+        void close();
+        bool readLine(std::string_view& line);
+        bool readFields(Fields& fields, char separator);
+
+        static void split(std::string_view line, char separator, Fields& fields);
+        static int toInt(std::string_view str);
+
+    private:
+        ConfFile(const ConfFile&);
+        ConfFile& operator=(const ConfFile&);
+
+        const char* _data;
+        size_t _size;
+        size_t _pos;
+};
+#endif
@@ -3,16 +3,30 @@
 #include "typedef.h"
 #include <vector>
 #include <string>
+#include <stdint.h>
 class Course {
     public:
-        Course(std::vector<std::string> data);
+        Course(const Fields& data, size_t index);
         virtual ~Course() { };
-        virtual void teach();
+        virtual void teach(size_t semester);
         virtual void reg(Student& s) = 0;
         virtual std::string getDept() { return _dept; };
         virtual std::string getName() { return _name; };
         virtual size_t getSemester() { return _semester; };
         virtual size_t getMinGrade() { return _min_grade; };
+        virtual size_t getIndex() { return _index; };
+        // the smallest exam draw (mod 101) that passes a course with
+        // min_grade, so the exam is a compare instead of a sqrt
+        static unsigned getPassMark(size_t min_grade);
+        // the outcomes of a whole roster at once, as Student::resolve()
+        // gives them one by one: a workload draw (mod 101) below the
+        // student's drop chance drops the course, an exam draw (mod 101)
+        // below pass_mark fails it. no branches, so it vectorizes.
+        static void resolveRoster(size_t count, const uint32_t* workload,
+                                  const uint32_t* exam,
+                                  const unsigned char* drop_chances,
+                                  const unsigned char* drop_events,
+                                  unsigned pass_mark, unsigned char* outcomes);
 
     protected:
         Students _students;
@@ -20,6 +34,9 @@ class Course {
         std::string _name;
         size_t _semester;
         size_t _min_grade;
+        unsigned _pass_mark;
+        // position in courses.conf, among all departments
+        size_t _index;
 
         virtual void reset();
 };
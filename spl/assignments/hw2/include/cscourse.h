@@ -4,7 +4,7 @@
 #include <string>
 class CSCourse : public Course {
     public:
-        CSCourse(std::vector<std::string> data);
+        CSCourse(const Fields& data, size_t index);
         virtual void reg(Student& s);
 };
 #endif
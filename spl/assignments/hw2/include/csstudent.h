@@ -3,7 +3,9 @@
 #include "student.h"
 class CSStudent : public Student {
     public:
-        CSStudent(std::vector<std::string> data, int elective_courses_count);
-        virtual void study(Course& c);
+        CSStudent(const Fields& data, int elective_courses_count,
+                  size_t course_count);
+        virtual unsigned getDropChance() { return 25; };
+        virtual LogEvent getDropEvent() { return LOG_QUITS; };
 };
 #endif
@@ -0,0 +1,22 @@
+#ifndef CURRICULUM_H
+#define CURRICULUM_H
+#include <vector>
+#include "typedef.h"
+
+// the courses a student of a dept can be registered to, grouped once at
+// load time: dept courses by their semester, electives by the parity of
+// theirs. every group keeps courses.conf order.
+class Curriculum {
+    public:
+        Curriculum(Courses& dept_courses, Courses& elective_courses);
+        // empty for a semester with no dept courses
+        const Courses& getSemesterCourses(size_t semester) const;
+        // the electives given in a semester of the same parity
+        const Courses& getElectiveCourses(size_t semester) const;
+
+    private:
+        std::vector<Courses> _semester_courses;
+        Courses _elective_courses[2];
+        Courses _no_courses;
+};
+#endif
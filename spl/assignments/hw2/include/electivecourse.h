@@ -3,7 +3,7 @@
 #include "course.h"
 class ElectiveCourse : public Course {
     public:
-        ElectiveCourse(std::vector<std::string> data);
+        ElectiveCourse(const Fields& data, size_t index);
         virtual void reg(Student& s);
 };
 #endif
@@ -0,0 +1,48 @@
+#ifndef ENSEMBLE_H
+#define ENSEMBLE_H
+#include <vector>
+#include <iostream>
+#include <stdint.h>
+#include <boost/atomic.hpp>
+#include "typedef.h"
+
+// many universes of the same university, each drawn from a seed of its
+// own: universe k of a run from seed S uses seed S+k, and is the one a
+// single run with --seed S+k simulates. every thread keeps a TableEngine
+// and runs one universe after the other on it, nothing is logged, and
+// what every universe ended with is kept, so the report is the same on
+// any number of threads.
+class Ensemble {
+    public:
+        Ensemble(Students& students, Courses& CS_courses, Courses& PG_courses,
+                 Courses& elective_courses, Courses& all_courses, bool malag,
+                 size_t semesters, size_t CS_courses_needed,
+                 size_t PG_courses_needed);
+        void run(size_t universes, uint64_t seed, size_t threads);
+        void print(std::ostream& output) const;
+
+    private:
+        Ensemble(const Ensemble&);
+        Ensemble& operator=(const Ensemble&);
+
+        void work();
+        static void printRate(std::ostream& output, const std::vector<double>& rates);
+
+        Students& _students;
+        Courses& _CS_courses;
+        Courses& _PG_courses;
+        Courses& _elective_courses;
+        Courses& _all_courses;
+        bool _malag;
+        size_t _semesters;
+        size_t _courses_needed[2];
+        size_t _universes;
+        uint64_t _seed;
+        // per universe: students of every dept who graduated, and per
+        // universe and course: the times the course was taken and passed
+        std::vector<size_t> _graduates[2];
+        std::vector<size_t> _taken;
+        std::vector<size_t> _passed;
+        boost::atomic<size_t> _next_universe;
+};
+#endif
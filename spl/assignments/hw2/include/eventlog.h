@@ -0,0 +1,49 @@
+#ifndef EVENTLOG_H
+#define EVENTLOG_H
+#include <string>
+#include <string_view>
+#include <vector>
+#include <stdint.h>
+
+class LogBuffer;
+
+// the events random.log is made of, and the line every one of them
+// stands for.
+enum LogEvent {
+    LOG_DENIED,         // ID is being denied his education.
+    LOG_SEMESTER,       // Semester S of Random University.
+    LOG_TAKING,         // ID is taking NAME from DEPT
+    LOG_QUITS,          // ID quits course NAME
+    LOG_SLACKING,       // ID is slacking off NAME
+    LOG_FAILED,         // ID took NAME and finished UNSUCCESSFULLY
+    LOG_PASSED,         // ID took NAME and finished SUCCESSFULLY
+    LOG_GRADUATED,      // ID has graduated
+    LOG_NOT_GRADUATED   // ID has not graduated
+};
+
+// the binary log: a header, the course table as DEPT,NAME lines in
+// course index order, then one fixed width record per event. numbers
+// are native endian. bin/decodelog turns it back into random.log.
+struct LogHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t course_count;
+    uint64_t table_size;
+};
+
+struct LogRecord {
+    uint32_t student;
+    uint32_t course;    // NO_LOG_COURSE for events without one
+    uint16_t semester;  // 0 before the first semester
+    uint8_t event;
+    uint8_t unused;
+};
+
+const uint32_t NO_LOG_COURSE = ~0u;
+extern const char LOG_MAGIC[8];
+const uint32_t LOG_VERSION = 1;
+
+// writes the event's line; name and dept are the course's, if it has one.
+void renderEvent(LogBuffer& output, LogEvent event, size_t student,
+                 size_t semester, std::string_view name, std::string_view dept);
+#endif
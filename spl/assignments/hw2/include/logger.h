@@ -0,0 +1,87 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <stdint.h>
+#include <boost/thread.hpp>
+
+class Logger;
+
+// the lines of one thread, not written yet. a held buffer keeps all of
+// its lines until they are taken out, so threads working on parts of
+// the same step can have their lines put in order afterwards.
+class LogBuffer {
+    public:
+        LogBuffer(Logger& logger);
+        LogBuffer& operator<<(std::string_view str);
+        LogBuffer& operator<<(size_t num);
+        void endLine();
+        void write(const void* data, size_t size);
+        void flush();
+        void hold();
+        void take(std::vector<char>& lines);
+
+    private:
+        LogBuffer(const LogBuffer&);
+        LogBuffer& operator=(const LogBuffer&);
+
+        Logger& _logger;
+        std::vector<char> _data;
+        bool _held;
+};
+
+// a log file written in the background. every thread formats its lines
+// into a buffer of its own, and full buffers are handed to a writer
+// thread that appends them to the file, so logging never waits for the
+// disk. lines of one thread keep their order; close() hands over the
+// calling thread's last lines and waits for the writer to finish, other
+// threads hand theirs over when they exit.
+class Logger {
+    public:
+        Logger();
+        ~Logger();
+        bool open(const std::string& filename);
+        // the log of an interrupted run: whatever came after its first
+        // size bytes is dropped, and new lines go after them.
+        bool reopen(const std::string& filename, uint64_t size);
+        bool close();
+        // waits until everything logged so far, by any thread, is in the
+        // file, and tells how big the file is then.
+        bool sync(uint64_t& size);
+        LogBuffer& buffer();
+        void append(std::vector<char>& lines);
+
+        static const size_t BUFFER_SIZE = 1 << 16;
+
+    private:
+        friend class LogBuffer;
+
+        Logger(const Logger&);
+        Logger& operator=(const Logger&);
+
+        void start();
+        static void flushBuffer(LogBuffer* buffer);
+        void handOver(std::vector<char>& data);
+        void writeBuffers();
+
+        // full buffers waiting for the writer before loggers have to wait
+        static const size_t MAX_QUEUED = 16;
+
+        int _fd;
+        bool _failed;
+        bool _closing;
+        // the writer has a buffer out of the queue
+        bool _busy;
+        uint64_t _written;
+        boost::thread_specific_ptr<LogBuffer> _buffers;
+        std::deque<std::vector<char> > _queue;
+        std::vector<std::vector<char> > _spare;
+        boost::mutex _mutex;
+        boost::condition_variable _ready;
+        boost::condition_variable _space;
+        boost::condition_variable _idle;
+        boost::thread _writer;
+};
+#endif
@@ -3,7 +3,7 @@
 #include "course.h"
 class PGCourse : public Course {
     public:
-        PGCourse(std::vector<std::string> data);
+        PGCourse(const Fields& data, size_t index);
         virtual void reg(Student& s);
 };
 #endif
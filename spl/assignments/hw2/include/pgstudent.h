@@ -3,7 +3,9 @@
 #include "student.h"
 class PGStudent : public Student {
     public:
-        PGStudent(std::vector<std::string> data, int elective_courses_count);
-        virtual void study(Course& c);
+        PGStudent(const Fields& data, int elective_courses_count,
+                  size_t course_count);
+        virtual unsigned getDropChance() { return 20; };
+        virtual LogEvent getDropEvent() { return LOG_SLACKING; };
 };
 #endif
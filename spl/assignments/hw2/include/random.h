@@ -0,0 +1,34 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+#include <stdint.h>
+#include <cstddef>
+
+// counter based random numbers (Philox4x32-10). the words drawn for a
+// student taking a course in a semester are a pure function of the seed
+// and those three, so any draw can be made on its own, on any thread, in
+// any order, and a run is the same for the same seed.
+class Random {
+    public:
+        static const size_t WORDS = 4;
+
+        static void setSeed(uint64_t seed);
+        static uint64_t getSeed();
+        static void draw(size_t student, size_t semester, size_t course,
+                         uint32_t words[WORDS]);
+        // the same, from a seed of its own
+        static void draw(uint64_t seed, size_t student, size_t semester,
+                         size_t course, uint32_t words[WORDS]);
+        // the first two words of the draws of count students taking the
+        // same course at once. the students are lanes that don't depend
+        // on each other, so the rounds are plain loops over arrays the
+        // compiler can vectorize.
+        static void draw(uint64_t seed, size_t count, const size_t* students,
+                         size_t semester, size_t course, uint32_t* first,
+                         uint32_t* second);
+
+    private:
+        static const size_t LANES = 64;
+
+        static uint64_t _seed;
+};
+#endif
@@ -0,0 +1,75 @@
+#ifndef SEMESTERENGINE_H
+#define SEMESTERENGINE_H
+#include <vector>
+#include <boost/atomic.hpp>
+#include <boost/thread.hpp>
+#include "typedef.h"
+#include "eventlog.h"
+#include "activestudents.h"
+
+// a semester on a pool of threads. students are split in chunks: every
+// chunk plans, registers and studies on its own, since what a student
+// gets in a course depends only on the seed, the student, the semester
+// and the course. the registrations are then merged into the courses
+// chunk by chunk, which gives every course the students in the order
+// the sequential run registers them, and the lines of every part are
+// appended in order, so random.log is exactly the sequential one.
+// the worker threads are started once, with the engine, and every step
+// of every semester is handed to all of them.
+class SemesterEngine {
+    public:
+        SemesterEngine(ActiveStudents& students, Courses& CS_courses,
+                       Courses& PG_courses, Courses& elective_courses,
+                       size_t course_count, bool malag, size_t threads);
+        ~SemesterEngine();
+        void run(size_t semester);
+
+    private:
+        SemesterEngine(const SemesterEngine&);
+        SemesterEngine& operator=(const SemesterEngine&);
+
+        struct Registration {
+            Student* student;
+            Course* course;
+            LogEvent outcome;
+        };
+
+        typedef void (SemesterEngine::*Step)(size_t chunk);
+
+        void runWorkers(Step step, size_t chunks);
+        void work();
+        void studyChunk(size_t chunk);
+        void reportChunk(size_t chunk);
+
+        static const size_t STUDENT_CHUNK = 1024;
+        static const size_t SEAT_CHUNK = 4096;
+
+        ActiveStudents& _students;
+        size_t _threads;
+        size_t _semester;
+        // the courses in the order they are taught
+        Courses _teaching;
+        // registrations of every chunk of students, in the order they
+        // were made
+        std::vector<std::vector<Registration> > _registrations;
+        // who took every course (by course index), in registration order
+        std::vector<std::vector<const Registration*> > _rosters;
+        // where every taught course starts among all the seats taught
+        std::vector<size_t> _first_seat;
+        // log lines of every chunk, until they are appended
+        std::vector<std::vector<char> > _lines;
+        boost::atomic<size_t> _next_chunk;
+
+        // the step the workers are on, and how many are still at it.
+        // every new step bumps _step_count, which wakes them up.
+        boost::thread_group _workers;
+        boost::mutex _mutex;
+        boost::condition_variable _step_ready;
+        boost::condition_variable _step_done;
+        Step _step;
+        size_t _chunks;
+        size_t _step_count;
+        size_t _working;
+        bool _stopping;
+};
+#endif
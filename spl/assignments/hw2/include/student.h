@@ -1,13 +1,29 @@
 #ifndef STUDENT_H
 #define STUDENT_H
 #include "typedef.h"
+#include "eventlog.h"
+#include <stdint.h>
 #include <vector>
 #include <string>
+
+struct StudentProgress;
+class Curriculum;
+
 class Student {
     public:
-        Student(std::vector<std::string> data, size_t elective_courses_count);
+        Student(const Fields& data, size_t elective_courses_count,
+                size_t course_count);
         virtual ~Student() { };
-        virtual void study(Course& c) = 0;
+        // what studying c this semester comes to, without acting on it:
+        // quitting, slacking off, failing or passing. the same for the
+        // same seed, whenever it is asked.
+        virtual LogEvent resolve(Course& c, size_t semester);
+        // the chance in 100 of dropping a course over the workload, and
+        // what dropping it is called in the log (quitting for CS,
+        // slacking off for PG)
+        virtual unsigned getDropChance() = 0;
+        virtual LogEvent getDropEvent() = 0;
+        virtual void pass(Course& c);
         virtual size_t getId() { return _id; };
         virtual std::string getDept() { return _dept; };
         virtual std::string getImage() { return _image; };
@@ -16,21 +32,42 @@ class Student {
         virtual bool hasSemesterCoursesLeft();
         virtual void addSemesterCourse(Course& c);
         virtual void addElectiveCourse(Course& c);
+        virtual void planSemester(size_t semester, const Curriculum& curriculum);
+        virtual void getRegistrations(size_t semester, Courses& courses);
         virtual void startSemester(size_t semester);
         virtual bool hasCompleted(Course& c);
         virtual bool hasGraduated(size_t dept_courses_count);
+        // nothing to take this semester or any later one: the electives
+        // are all passed, and so are the dept courses, or the curriculum
+        // has none for the student's next semester.
+        virtual bool isDone(const Curriculum& curriculum);
+        // between two semesters only: what a checkpoint keeps, and
+        // picking up from it. the course indexes are checked.
+        virtual void saveProgress(StudentProgress& progress);
+        virtual bool loadProgress(const StudentProgress& progress,
+                                  Courses& all_courses);
 
     protected:
         size_t _id;
         std::string _dept;
         std::string _image;
         size_t _elective_courses_count;
-        Courses _passed_courses;
         size_t _current_semester;
+        // the courses taken and not passed yet, in the order they were
+        // taken. passed ones are only dropped at the next registration,
+        // until then the counts below are what is left.
         Courses _semester_courses;
         Courses _elective_courses;
+        size_t _semester_courses_left;
+        size_t _elective_courses_left;
+        // by course index: passed, and taken as a dept or elective course
+        std::vector<bool> _passed;
+        std::vector<bool> _pending_semester;
+        std::vector<bool> _pending_electives;
+        size_t _passed_count;
 
-        virtual void takeExam(Course& c);
+        virtual LogEvent takeExam(Course& c, uint32_t draw);
         virtual void completeCourse(Course& c);
+        void dropPassed(Courses& courses, std::vector<bool>& pending);
 };
 #endif
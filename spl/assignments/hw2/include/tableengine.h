@@ -0,0 +1,98 @@
+#ifndef TABLEENGINE_H
+#define TABLEENGINE_H
+#include <vector>
+#include <stdint.h>
+#include "typedef.h"
+
+enum Department {
+    DEPT_CS,
+    DEPT_PG,
+    DEPT_ELECTIVE
+};
+
+// the simulation on flat tables instead of Student and Course objects:
+// one array per field, indexed by the student's place in the sorted
+// students vector or by the course index, and departments as numbers.
+// a semester registers everybody, then teaches every course's roster in
+// one go. the rules are the ones of Student, CSStudent and PGStudent, so
+// for the same seed the log is the one the objects write.
+class TableEngine {
+    public:
+        TableEngine(Students& students, Courses& CS_courses,
+                    Courses& PG_courses, Courses& elective_courses,
+                    Courses& all_courses, bool malag);
+        void run(size_t semester);
+        bool hasGraduated(size_t student, size_t dept_courses_count) const;
+        bool isStudying(size_t student) const;
+        Department getDept(size_t student) const;
+        size_t getStudentCount() const;
+        // back to before the first semester, for another universe of an
+        // ensemble: drawn from seed, and nothing is logged.
+        void reset(uint64_t seed);
+        // how many times the course was taken and passed so far
+        size_t getTakenCount(size_t course) const;
+        size_t getPassedCount(size_t course) const;
+
+    private:
+        TableEngine(const TableEngine&);
+        TableEngine& operator=(const TableEngine&);
+
+        void planSemester(size_t student, size_t semester);
+        void registerStudent(size_t student, size_t semester);
+        void teach(unsigned course, size_t semester);
+        void pass(size_t student, unsigned course);
+        bool hasPassed(size_t student, unsigned course) const;
+        bool isDone(size_t student) const;
+        void activateStudents();
+
+        Courses& _courses;
+        bool _malag;
+        uint64_t _seed;
+        bool _logging;
+        unsigned _required_electives[2];
+
+        // courses, by course index
+        std::vector<unsigned char> _course_dept;
+        std::vector<unsigned> _course_semester;
+        // the smallest exam draw (mod 101) that passes
+        std::vector<unsigned> _pass_mark;
+        std::vector<size_t> _taken;
+        std::vector<size_t> _passes;
+        // dept courses of every dept and semester, in courses.conf order
+        std::vector<std::vector<unsigned> > _term_courses[2];
+        std::vector<unsigned> _electives;
+        // the electives by the parity of their semester
+        std::vector<unsigned> _parity_electives[2];
+        // the courses in the order they are taught
+        std::vector<unsigned> _teaching;
+
+        // students, by their place in the sorted students vector
+        std::vector<size_t> _ids;
+        std::vector<unsigned char> _depts;
+        std::vector<unsigned> _current_semester;
+        std::vector<unsigned> _electives_wanted;
+        std::vector<unsigned> _semester_courses_left;
+        std::vector<unsigned> _elective_courses_left;
+        std::vector<unsigned> _passed_count;
+        // electives taken and not dropped yet, _elective_room slots per
+        // student: nobody takes more electives than were needed at first.
+        size_t _elective_room;
+        std::vector<unsigned> _taken_electives;
+        std::vector<unsigned> _taken_count;
+        // passed courses, _words words of bits per student
+        size_t _words;
+        std::vector<uint64_t> _passed;
+        // the students a semester visits, as ActiveStudents keeps them
+        std::vector<unsigned> _active;
+
+        // students registered to every course, in registration order,
+        // and the draws and outcomes of the roster being taught
+        std::vector<std::vector<unsigned> > _rosters;
+        std::vector<size_t> _roster_ids;
+        std::vector<uint32_t> _workload;
+        std::vector<uint32_t> _exam;
+        std::vector<unsigned char> _drop_chances;
+        std::vector<unsigned char> _drop_events;
+        std::vector<unsigned char> _outcomes;
+};
+#endif
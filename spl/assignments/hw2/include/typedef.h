@@ -1,6 +1,7 @@
 #ifndef TYPEDEF_H
 #define TYPEDEF_H
 #include <vector>
+#include <string_view>
 
 class Student;
 typedef std::vector<Student*> Students;
@@ -16,4 +17,7 @@ class PGCourse;
 class ElectiveCourse;
 
 class Utils;
+class ConfFile;
+
+typedef std::vector<std::string_view> Fields;
 #endif
@@ -2,14 +2,30 @@
 #define UTILS_H
 #include <string>
 #include <vector>
+#include <stdint.h>
+#include "typedef.h"
+#include "eventlog.h"
 using namespace std;
 class Utils {
     public:
-        static vector<string> str_split(string str, char separator);
-        static void log(string str);
-        static void log(size_t num, string str);
-        static void log(string str1, size_t num, string str2);
-        static void log(size_t num, string str1, string str2);
-        static void log(size_t num, string str1, string str2, string str3);
+        // random.log is written in the background between these two.
+        // a binary log needs the course table before the first event.
+        static bool openLog(const string& filename, bool binary);
+        // carries on with the log of an interrupted run, from size bytes
+        static bool resumeLog(const string& filename, bool binary, uint64_t size);
+        // everything logged so far is in the file, of size bytes
+        static bool syncLog(uint64_t& size);
+        static void logCourses(const Courses& courses);
+        static bool closeLog();
+
+        static void log(LogEvent event, size_t student, Course* course = 0);
+        static void logSemester(size_t semester);
+
+        // a thread working on part of a step keeps its lines from
+        // holdLog() on and takes them out with takeLog(), the caller
+        // appends every part in order with appendLog().
+        static void holdLog();
+        static void takeLog(vector<char>& lines);
+        static void appendLog(vector<char>& lines);
 };
 #endif
@@ -0,0 +1,35 @@
+#include <vector>
+#include "../include/activestudents.h"
+#include "../include/student.h"
+using namespace std;
+
+ActiveStudents::ActiveStudents(Students& students,
+                               const Curriculum& CS_curriculum,
+                               const Curriculum& PG_curriculum, bool malag):
+    _students(),
+    _curriculums()
+{
+    for (size_t i = 0; i < students.size(); ++i) {
+        Student* student = students[i];
+        if (student->getDept() == "CS") {
+            _students.push_back(student);
+            _curriculums.push_back(&CS_curriculum);
+        } else if (malag) {
+            _students.push_back(student);
+            _curriculums.push_back(&PG_curriculum);
+        }
+    }
+}
+
+void ActiveStudents::update() {
+    size_t left = 0;
+    for (size_t i = 0; i < _students.size(); ++i) {
+        if (!_students[i]->isDone(*_curriculums[i])) {
+            _students[left] = _students[i];
+            _curriculums[left] = _curriculums[i];
+            ++left;
+        }
+    }
+    _students.resize(left);
+    _curriculums.resize(left);
+}
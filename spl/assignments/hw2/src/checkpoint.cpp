@@ -0,0 +1,137 @@
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include "../include/checkpoint.h"
+#include "../include/student.h"
+using namespace std;
+
+const char CHECKPOINT_MAGIC[8] = "RUCKPT";
+
+static void append(vector<char>& data, const void* bytes, size_t size) {
+    const char* first = static_cast<const char*>(bytes);
+    data.insert(data.end(), first, first + size);
+}
+
+bool saveCheckpoint(const string& filename, const CheckpointHeader& header,
+                    Students& students)
+{
+    // the whole checkpoint is put together in memory and written at once
+    vector<char> data;
+    append(data, &header, sizeof(header));
+
+    StudentProgress progress;
+    for (size_t i = 0; i < students.size(); ++i) {
+        students[i]->saveProgress(progress);
+
+        ProgressRecord record;
+        record.student = students[i]->getId();
+        record.current_semester = progress.current_semester;
+        record.electives_wanted = progress.electives_wanted;
+        record.passed_count = progress.passed_count;
+        record.semester_course_count = progress.semester_courses.size();
+        record.elective_course_count = progress.elective_courses.size();
+        append(data, &record, sizeof(record));
+        if (!progress.passed.empty()) {
+            append(data, &progress.passed[0], progress.passed.size() * sizeof(uint64_t));
+        }
+        if (!progress.semester_courses.empty()) {
+            append(data, &progress.semester_courses[0],
+                   progress.semester_courses.size() * sizeof(uint32_t));
+        }
+        if (!progress.elective_courses.empty()) {
+            append(data, &progress.elective_courses[0],
+                   progress.elective_courses.size() * sizeof(uint32_t));
+        }
+    }
+
+    string temporary = filename + ".tmp";
+    ofstream output(temporary.c_str(), ios::binary | ios::trunc);
+    output.write(&data[0], data.size());
+    output.close();
+    if (!output) {
+        remove(temporary.c_str());
+        return false;
+    }
+
+    return rename(temporary.c_str(), filename.c_str()) == 0;
+}
+
+bool readCheckpointHeader(const string& filename, CheckpointHeader& header) {
+    ifstream input(filename.c_str(), ios::binary);
+    if (!input.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        return false;
+    }
+
+    return memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) == 0
+        && header.version == CHECKPOINT_VERSION;
+}
+
+bool loadCheckpoint(const string& filename, Students& students,
+                    Courses& all_courses)
+{
+    ifstream input(filename.c_str(), ios::binary);
+    vector<char> data((istreambuf_iterator<char>(input)),
+                      istreambuf_iterator<char>());
+
+    CheckpointHeader header;
+    if (data.size() < sizeof(header)) {
+        return false;
+    }
+    memcpy(&header, &data[0], sizeof(header));
+    if (memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0
+        || header.version != CHECKPOINT_VERSION
+        || header.student_count != students.size()
+        || header.course_count != all_courses.size())
+    {
+        return false;
+    }
+
+    size_t words = (all_courses.size() + 63) / 64;
+    size_t pos = sizeof(header);
+    StudentProgress progress;
+    for (size_t i = 0; i < students.size(); ++i) {
+        ProgressRecord record;
+        if (data.size() - pos < sizeof(record)) {
+            return false;
+        }
+        memcpy(&record, &data[pos], sizeof(record));
+        pos += sizeof(record);
+
+        size_t courses = record.semester_course_count + record.elective_course_count;
+        if (record.student != students[i]->getId()
+            || data.size() - pos < words * sizeof(uint64_t) + courses * sizeof(uint32_t))
+        {
+            return false;
+        }
+
+        progress.current_semester = record.current_semester;
+        progress.electives_wanted = record.electives_wanted;
+        progress.passed_count = record.passed_count;
+        progress.passed.resize(words);
+        if (words > 0) {
+            memcpy(&progress.passed[0], &data[pos], words * sizeof(uint64_t));
+            pos += words * sizeof(uint64_t);
+        }
+
+        progress.semester_courses.resize(record.semester_course_count);
+        progress.elective_courses.resize(record.elective_course_count);
+        if (record.semester_course_count > 0) {
+            memcpy(&progress.semester_courses[0], &data[pos],
+                   record.semester_course_count * sizeof(uint32_t));
+            pos += record.semester_course_count * sizeof(uint32_t);
+        }
+        if (record.elective_course_count > 0) {
+            memcpy(&progress.elective_courses[0], &data[pos],
+                   record.elective_course_count * sizeof(uint32_t));
+            pos += record.elective_course_count * sizeof(uint32_t);
+        }
+
+        if (!students[i]->loadProgress(progress, all_courses)) {
+            return false;
+        }
+    }
+
+    return pos == data.size();
+}
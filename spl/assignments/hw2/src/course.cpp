@@ -2,29 +2,89 @@
 #include "../include/utils.h"
 #include "../include/course.h"
 #include "../include/student.h"
+#include "../include/conffile.h"
+#include "../include/random.h"
 #include <iostream>
 #include <vector>
 #include <string>
 #include <cstdlib>
+#include <cmath>
 using namespace std;
 
-Course::Course(std::vector<std::string> data):
+Course::Course(const Fields& data, size_t index):
     _students(),
     _dept(data[0]),
     _name(data[1]),
-    _semester(atoi(data[2].c_str())),
-    _min_grade(atoi(data[3].c_str()))
+    _semester(ConfFile::toInt(data[2])),
+    _min_grade(ConfFile::toInt(data[3])),
+    _pass_mark(getPassMark(_min_grade)),
+    _index(index)
 {
 }
 
-void Course::teach() {
-    for (size_t i = 0; i < _students.size(); ++i) {
-        _students[i]->study(*this);
+void Course::teach(size_t semester) {
+    // the whole roster is drawn and resolved in one go: nothing a
+    // student passes changes the draws. then every student passes and
+    // is logged in registration order, like study() does one by one.
+    size_t count = _students.size();
+    if (count == 0) {
+        reset();
+        return;
+    }
+
+    vector<size_t> ids(count);
+    vector<unsigned char> drop_chances(count);
+    vector<unsigned char> drop_events(count);
+    for (size_t i = 0; i < count; ++i) {
+        ids[i] = _students[i]->getId();
+        drop_chances[i] = _students[i]->getDropChance();
+        drop_events[i] = _students[i]->getDropEvent();
+    }
+
+    vector<uint32_t> workload(count);
+    vector<uint32_t> exam(count);
+    vector<unsigned char> outcomes(count);
+    Random::draw(Random::getSeed(), count, &ids[0], semester, _index,
+                 &workload[0], &exam[0]);
+    resolveRoster(count, &workload[0], &exam[0], &drop_chances[0],
+                  &drop_events[0], _pass_mark, &outcomes[0]);
+
+    for (size_t i = 0; i < count; ++i) {
+        LogEvent outcome = static_cast<LogEvent>(outcomes[i]);
+        if (outcome == LOG_PASSED) {
+            _students[i]->pass(*this);
+        }
+        Utils::log(outcome, ids[i], this);
     }
 
     reset();
 }
 
+unsigned Course::getPassMark(size_t min_grade) {
+    // the exam is passed unless 10*sqrt(draw%101) < min grade, as in
+    // Student::takeExam()
+    unsigned mark = 0;
+    while (mark <= 100 && 10*sqrt(mark) < min_grade) {
+        ++mark;
+    }
+
+    return mark;
+}
+
+void Course::resolveRoster(size_t count, const uint32_t* workload,
+                           const uint32_t* exam,
+                           const unsigned char* drop_chances,
+                           const unsigned char* drop_events,
+                           unsigned pass_mark, unsigned char* outcomes)
+{
+    for (size_t i = 0; i < count; ++i) {
+        // both are worked out, and one is picked
+        unsigned char dropped = drop_events[i];
+        unsigned char taken = (exam[i]%101 < pass_mark) ? LOG_FAILED : LOG_PASSED;
+        outcomes[i] = (workload[i]%101 < drop_chances[i]) ? dropped : taken;
+    }
+}
+
 void Course::reset() {
     // the semester ended. clean the course registration list.
     _students.clear();
@@ -8,12 +8,12 @@
 #include <fstream>
 using namespace std;
 
-CSCourse::CSCourse(std::vector<std::string> data) : Course(data) {
+CSCourse::CSCourse(const Fields& data, size_t index) : Course(data, index) {
 
 }
 
 void CSCourse::reg(Student& s) {
     _students.push_back(&s);
     
-    Utils::log(s.getId(), " is taking ", _name, " from CS");
+    Utils::log(LOG_TAKING, s.getId(), this);
 }
@@ -0,0 +1,34 @@
+#include <vector>
+#include "../include/curriculum.h"
+#include "../include/course.h"
+using namespace std;
+
+Curriculum::Curriculum(Courses& dept_courses, Courses& elective_courses):
+    _semester_courses(),
+    _elective_courses(),
+    _no_courses()
+{
+    for (size_t i = 0; i < dept_courses.size(); ++i) {
+        size_t semester = dept_courses[i]->getSemester();
+        if (_semester_courses.size() <= semester) {
+            _semester_courses.resize(semester + 1);
+        }
+        _semester_courses[semester].push_back(dept_courses[i]);
+    }
+
+    for (size_t i = 0; i < elective_courses.size(); ++i) {
+        _elective_courses[elective_courses[i]->getSemester()%2].push_back(elective_courses[i]);
+    }
+}
+
+const Courses& Curriculum::getSemesterCourses(size_t semester) const {
+    if (semester >= _semester_courses.size()) {
+        return _no_courses;
+    }
+
+    return _semester_courses[semester];
+}
+
+const Courses& Curriculum::getElectiveCourses(size_t semester) const {
+    return _elective_courses[semester%2];
+}
@@ -0,0 +1,106 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstring>
+
+#include "../include/eventlog.h"
+#include "../include/logger.h"
+#include "../include/conffile.h"
+
+using namespace std;
+
+// decodelog BINARY-LOG [TEXT-LOG]: writes the random.log (or TEXT-LOG)
+// the run that wrote BINARY-LOG with --binary-log would have written.
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cout << "usage: decodelog BINARY-LOG [TEXT-LOG]" << endl;
+        return 1;
+    }
+    string text_log = (argc > 2) ? argv[2] : "random.log";
+
+    ifstream input(argv[1], ios::binary);
+    LogHeader header;
+    if (!input.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || memcmp(header.magic, LOG_MAGIC, sizeof(header.magic)) != 0
+        || header.version != LOG_VERSION)
+    {
+        cout << "Unable to read " << argv[1] << "." << endl;
+        return 1;
+    }
+
+    // the course table: DEPT,NAME lines in course index order. a corrupt
+    // size must not make us allocate or read past the end of the file.
+    streampos table_start = input.tellg();
+    input.seekg(0, ios::end);
+    uint64_t rest = static_cast<uint64_t>(input.tellg() - table_start);
+    input.seekg(table_start);
+    if (header.table_size > rest) {
+        cout << "Unable to read " << argv[1] << "." << endl;
+        return 1;
+    }
+
+    string table(header.table_size, '\0');
+    if (!table.empty() && !input.read(&table[0], table.size())) {
+        cout << "Unable to read " << argv[1] << "." << endl;
+        return 1;
+    }
+
+    Fields lines;
+    vector<string_view> depts;
+    vector<string_view> names;
+    ConfFile::split(table, '\n', lines);
+    for (size_t i = 0; i < lines.size(); ++i) {
+        size_t comma = lines[i].find(',');
+        depts.push_back(lines[i].substr(0, comma));
+        names.push_back(lines[i].substr(comma + 1));
+    }
+
+    if (names.size() != header.course_count) {
+        cout << "Unable to read " << argv[1] << "." << endl;
+        return 1;
+    }
+
+    Logger output;
+    if (!output.open(text_log)) {
+        cout << "Unable to open " << text_log << "." << endl;
+        return 1;
+    }
+
+    LogBuffer& buffer = output.buffer();
+    vector<LogRecord> records(4096);
+    for (;;) {
+        input.read(reinterpret_cast<char*>(&records[0]), records.size()*sizeof(LogRecord));
+        size_t count = input.gcount()/sizeof(LogRecord);
+        if (count == 0) {
+            break;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            const LogRecord& record = records[i];
+            if (record.event > LOG_NOT_GRADUATED) {
+                cout << "Bad event in " << argv[1] << "." << endl;
+                return 1;
+            }
+
+            if (record.course == NO_LOG_COURSE) {
+                renderEvent(buffer, static_cast<LogEvent>(record.event), record.student,
+                            record.semester, "", "");
+            } else if (record.course < names.size()) {
+                renderEvent(buffer, static_cast<LogEvent>(record.event), record.student,
+                            record.semester, names[record.course], depts[record.course]);
+            } else {
+                cout << "Bad course index in " << argv[1] << "." << endl;
+                return 1;
+            }
+        }
+    }
+
+    if (!output.close()) {
+        cout << "Unable to write " << text_log << "." << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -5,12 +5,12 @@
 #include <fstream>
 using namespace std;
 
-ElectiveCourse::ElectiveCourse(std::vector<std::string> data) : Course(data) {
+ElectiveCourse::ElectiveCourse(const Fields& data, size_t index) : Course(data, index) {
 
 }
 
 void ElectiveCourse::reg(Student& s) {
     _students.push_back(&s);
     
-    Utils::log(s.getId(), " is taking ", _name, " from ELECTIVE");
+    Utils::log(LOG_TAKING, s.getId(), this);
 }
@@ -0,0 +1,167 @@
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <algorithm>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include "../include/ensemble.h"
+#include "../include/tableengine.h"
+#include "../include/student.h"
+#include "../include/course.h"
+using namespace std;
+
+Ensemble::Ensemble(Students& students, Courses& CS_courses, Courses& PG_courses,
+                   Courses& elective_courses, Courses& all_courses, bool malag,
+                   size_t semesters, size_t CS_courses_needed,
+                   size_t PG_courses_needed):
+    _students(students),
+    _CS_courses(CS_courses),
+    _PG_courses(PG_courses),
+    _elective_courses(elective_courses),
+    _all_courses(all_courses),
+    _malag(malag),
+    _semesters(semesters),
+    _courses_needed(),
+    _universes(0),
+    _seed(0),
+    _graduates(),
+    _taken(),
+    _passed(),
+    _next_universe(0)
+{
+    _courses_needed[DEPT_CS] = CS_courses_needed;
+    _courses_needed[DEPT_PG] = PG_courses_needed;
+}
+
+void Ensemble::run(size_t universes, uint64_t seed, size_t threads) {
+    _universes = universes;
+    _seed = seed;
+    _graduates[DEPT_CS].assign(universes, 0);
+    _graduates[DEPT_PG].assign(universes, 0);
+    _taken.assign(universes * _all_courses.size(), 0);
+    _passed.assign(universes * _all_courses.size(), 0);
+
+    if (threads == 0) {
+        threads = max(boost::thread::hardware_concurrency(), 1u);
+    }
+
+    _next_universe = 0;
+    boost::thread_group workers;
+    for (size_t i = 0; i < threads; ++i) {
+        workers.create_thread(boost::bind(&Ensemble::work, this));
+    }
+    workers.join_all();
+}
+
+void Ensemble::work() {
+    // the tables are built once per thread, and only reset between
+    // universes
+    TableEngine engine(_students, _CS_courses, _PG_courses, _elective_courses,
+                       _all_courses, _malag);
+    size_t course_count = _all_courses.size();
+
+    for (;;) {
+        size_t universe = _next_universe.fetch_add(1);
+        if (universe >= _universes) {
+            return;
+        }
+
+        engine.reset(_seed + universe);
+        for (size_t semester = 1; semester <= _semesters; ++semester) {
+            engine.run(semester);
+        }
+
+        // every universe has slots of its own, no locking
+        for (size_t i = 0; i < engine.getStudentCount(); ++i) {
+            Department dept = engine.getDept(i);
+            if (engine.isStudying(i) && engine.hasGraduated(i, _courses_needed[dept])) {
+                _graduates[dept][universe]++;
+            }
+        }
+
+        for (size_t course = 0; course < course_count; ++course) {
+            _taken[universe * course_count + course] = engine.getTakenCount(course);
+            _passed[universe * course_count + course] = engine.getPassedCount(course);
+        }
+    }
+}
+
+void Ensemble::printRate(ostream& output, const vector<double>& rates) {
+    // the mean over the universes, with a 95% confidence interval
+    double sum = 0;
+    for (size_t i = 0; i < rates.size(); ++i) {
+        sum += rates[i];
+    }
+    double mean = sum / rates.size();
+
+    double squares = 0;
+    for (size_t i = 0; i < rates.size(); ++i) {
+        squares += (rates[i] - mean) * (rates[i] - mean);
+    }
+    double margin = 0;
+    if (rates.size() > 1) {
+        margin = 1.96 * sqrt(squares / (rates.size() - 1) / rates.size());
+    }
+
+    output << 100*mean << "% (95% CI " << 100*(mean - margin) << "% to "
+           << 100*(mean + margin) << "%)";
+}
+
+void Ensemble::print(ostream& output) const {
+    size_t dept_students[2] = { 0, 0 };
+    for (size_t i = 0; i < _students.size(); ++i) {
+        if (_students[i]->getDept() == "CS") {
+            dept_students[DEPT_CS]++;
+        } else {
+            dept_students[DEPT_PG]++;
+        }
+    }
+
+    output << fixed << setprecision(2);
+    output << "Ensemble of " << _universes << " universes, seeds " << _seed
+           << " to " << _seed + _universes - 1 << "." << endl;
+
+    const char* dept_names[2] = { "CS", "PG" };
+    for (size_t dept = 0; dept < 2; ++dept) {
+        if (dept_students[dept] == 0) {
+            continue;
+        }
+        if (dept == DEPT_PG && !_malag) {
+            output << "PG students were denied their education." << endl;
+            continue;
+        }
+
+        vector<double> rates(_universes);
+        for (size_t universe = 0; universe < _universes; ++universe) {
+            rates[universe] = static_cast<double>(_graduates[dept][universe])
+                              / dept_students[dept];
+        }
+        output << dept_names[dept] << " students graduated: ";
+        printRate(output, rates);
+        output << endl;
+    }
+
+    size_t course_count = _all_courses.size();
+    for (size_t course = 0; course < course_count; ++course) {
+        // only the universes the course was taken in count
+        vector<double> rates;
+        for (size_t universe = 0; universe < _universes; ++universe) {
+            size_t taken = _taken[universe * course_count + course];
+            if (taken > 0) {
+                rates.push_back(static_cast<double>(_passed[universe * course_count + course])
+                                / taken);
+            }
+        }
+
+        output << _all_courses[course]->getName() << " from "
+               << _all_courses[course]->getDept();
+        if (rates.empty()) {
+            output << " was never taken." << endl;
+            continue;
+        }
+        output << " passed: ";
+        printRate(output, rates);
+        output << endl;
+    }
+}
@@ -0,0 +1,42 @@
+#include <string_view>
+#include "../include/eventlog.h"
+#include "../include/logger.h"
+using namespace std;
+
+const char LOG_MAGIC[8] = { 'R', 'U', 'L', 'O', 'G', 0, 0, 0 };
+
+void renderEvent(LogBuffer& output, LogEvent event, size_t student,
+                 size_t semester, string_view name, string_view dept)
+{
+    // the exact lines Utils::log used to write
+    switch (event) {
+        case LOG_DENIED:
+            output << student << " is being denied his education.";
+            break;
+        case LOG_SEMESTER:
+            output << "Semester " << semester << " of Random University.";
+            break;
+        case LOG_TAKING:
+            output << student << " is taking " << name << " from " << dept;
+            break;
+        case LOG_QUITS:
+            output << student << " quits course " << name;
+            break;
+        case LOG_SLACKING:
+            output << student << " is slacking off " << name;
+            break;
+        case LOG_FAILED:
+            output << student << " took " << name << " and finished UNSUCCESSFULLY";
+            break;
+        case LOG_PASSED:
+            output << student << " took " << name << " and finished SUCCESSFULLY";
+            break;
+        case LOG_GRADUATED:
+            output << student << " has graduated";
+            break;
+        case LOG_NOT_GRADUATED:
+            output << student << " has not graduated";
+            break;
+    }
+    output.endLine();
+}
@@ -0,0 +1,270 @@
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <cstring>
+#include <cerrno>
+#include <charconv>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <boost/thread.hpp>
+#include "../include/logger.h"
+using namespace std;
+
+LogBuffer::LogBuffer(Logger& logger):
+    _logger(logger),
+    _data(),
+    _held(false)
+{
+    _data.reserve(Logger::BUFFER_SIZE);
+}
+
+LogBuffer& LogBuffer::operator<<(string_view str) {
+    _data.insert(_data.end(), str.begin(), str.end());
+    return *this;
+}
+
+LogBuffer& LogBuffer::operator<<(size_t num) {
+    char digits[24];
+    to_chars_result result = to_chars(digits, digits + sizeof(digits), num);
+    _data.insert(_data.end(), digits, result.ptr);
+    return *this;
+}
+
+void LogBuffer::endLine() {
+    // a buffer is only handed over between lines
+    _data.push_back('\n');
+    if (!_held && _data.size() >= Logger::BUFFER_SIZE) {
+        flush();
+    }
+}
+
+void LogBuffer::write(const void* data, size_t size) {
+    // a whole record, handed over like a line
+    const char* bytes = static_cast<const char*>(data);
+    _data.insert(_data.end(), bytes, bytes + size);
+    if (!_held && _data.size() >= Logger::BUFFER_SIZE) {
+        flush();
+    }
+}
+
+void LogBuffer::flush() {
+    if (!_data.empty()) {
+        _logger.handOver(_data);
+    }
+    _held = false;
+}
+
+void LogBuffer::hold() {
+    _held = true;
+}
+
+void LogBuffer::take(vector<char>& lines) {
+    // the held lines go to the caller, who decides where they belong
+    lines.clear();
+    lines.swap(_data);
+    _data.reserve(Logger::BUFFER_SIZE);
+}
+
+Logger::Logger():
+    _fd(-1),
+    _failed(false),
+    _closing(false),
+    _busy(false),
+    _written(0),
+    _buffers(&Logger::flushBuffer),
+    _queue(),
+    _spare(),
+    _mutex(),
+    _ready(),
+    _space(),
+    _idle(),
+    _writer()
+{
+}
+
+Logger::~Logger() {
+    close();
+
+    // the calling thread's buffer goes while the rest is still here
+    _buffers.reset();
+}
+
+bool Logger::open(const string& filename) {
+    close();
+
+    // truncates, like the old "clean log file" step did.
+    _fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (_fd < 0) {
+        return false;
+    }
+
+    _written = 0;
+    start();
+    return true;
+}
+
+bool Logger::reopen(const string& filename, uint64_t size) {
+    close();
+
+    _fd = ::open(filename.c_str(), O_WRONLY);
+    if (_fd < 0) {
+        return false;
+    }
+
+    // a log shorter than size lost lines the run went on without
+    struct stat status;
+    if (fstat(_fd, &status) < 0 || static_cast<uint64_t>(status.st_size) < size
+        || ftruncate(_fd, size) < 0 || lseek(_fd, size, SEEK_SET) < 0)
+    {
+        ::close(_fd);
+        _fd = -1;
+        return false;
+    }
+
+    _written = size;
+    start();
+    return true;
+}
+
+void Logger::start() {
+    _failed = false;
+    _closing = false;
+    _busy = false;
+    _writer = boost::thread(&Logger::writeBuffers, this);
+}
+
+bool Logger::close() {
+    if (_fd < 0) {
+        return true;
+    }
+
+    if (_buffers.get() != 0) {
+        _buffers->flush();
+    }
+
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        _closing = true;
+    }
+    _ready.notify_one();
+    _writer.join();
+
+    if (::close(_fd) < 0) {
+        _failed = true;
+    }
+    _fd = -1;
+    return !_failed;
+}
+
+bool Logger::sync(uint64_t& size) {
+    if (_buffers.get() != 0) {
+        _buffers->flush();
+    }
+
+    boost::mutex::scoped_lock lock(_mutex);
+    while (!_queue.empty() || _busy) {
+        _idle.wait(lock);
+    }
+    size = _written;
+    return !_failed;
+}
+
+LogBuffer& Logger::buffer() {
+    if (_buffers.get() == 0) {
+        _buffers.reset(new LogBuffer(*this));
+    }
+
+    return *_buffers;
+}
+
+void Logger::append(vector<char>& lines) {
+    // after whatever the calling thread logged so far
+    buffer().flush();
+    if (!lines.empty()) {
+        handOver(lines);
+    }
+}
+
+void Logger::flushBuffer(LogBuffer* buffer) {
+    // the thread is done, whatever it logged still goes to the file
+    buffer->flush();
+    delete buffer;
+}
+
+void Logger::handOver(vector<char>& data) {
+    boost::mutex::scoped_lock lock(_mutex);
+    if (_fd < 0) {
+        // nowhere to write it
+        data.clear();
+        return;
+    }
+
+    while (_queue.size() >= MAX_QUEUED) {
+        _space.wait(lock);
+    }
+
+    _queue.push_back(vector<char>());
+    _queue.back().swap(data);
+
+    // carry on with a buffer the writer is done with, if there is one
+    if (!_spare.empty()) {
+        data.swap(_spare.back());
+        _spare.pop_back();
+    } else {
+        data.reserve(BUFFER_SIZE);
+    }
+    _ready.notify_one();
+}
+
+void Logger::writeBuffers() {
+    vector<char> data;
+    // _failed as of taking the buffer: it is only touched under _mutex
+    bool failed = false;
+    for (;;) {
+        {
+            boost::mutex::scoped_lock lock(_mutex);
+            if (_busy) {
+                _written += data.size();
+                data.clear();
+                _spare.push_back(vector<char>());
+                _spare.back().swap(data);
+                _busy = false;
+                _idle.notify_all();
+            }
+
+            while (_queue.empty() && !_closing) {
+                _ready.wait(lock);
+            }
+
+            if (_queue.empty()) {
+                return;
+            }
+
+            data.swap(_queue.front());
+            _queue.pop_front();
+            _busy = true;
+            failed = _failed;
+        }
+        _space.notify_one();
+
+        const char* next = &data[0];
+        size_t left = data.size();
+        while (left > 0 && !failed) {
+            ssize_t written = ::write(_fd, next, left);
+            if (written < 0) {
+                if (errno != EINTR) {
+                    // the lines are lost, close() reports it
+                    boost::mutex::scoped_lock lock(_mutex);
+                    _failed = true;
+                    failed = true;
+                }
+                continue;
+            }
+
+            next += written;
+            left -= written;
+        }
+    }
+}
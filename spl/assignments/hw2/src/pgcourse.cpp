@@ -5,12 +5,12 @@
 #include <fstream>
 using namespace std;
 
-PGCourse::PGCourse(std::vector<std::string> data) : Course(data) {
+PGCourse::PGCourse(const Fields& data, size_t index) : Course(data, index) {
 
 }
 
 void PGCourse::reg(Student& s) {
     _students.push_back(&s);
 
-    Utils::log(s.getId(), " is taking ", _name, " from PG");
+    Utils::log(LOG_TAKING, s.getId(), this);
 }
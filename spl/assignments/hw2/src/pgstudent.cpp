@@ -2,24 +2,12 @@
 #include "../include/utils.h"
 #include "../include/course.h"
 #include "../include/pgstudent.h"
-#include <cstdlib>
 #include <fstream>
 using namespace std;
 
-PGStudent::PGStudent(std::vector<std::string> data, 
-                     int elective_courses_count) 
-                    : Student(data, elective_courses_count) 
+PGStudent::PGStudent(const Fields& data, 
+                     int elective_courses_count,
+                     size_t course_count) 
+                    : Student(data, elective_courses_count, course_count) 
 {
 }
-
-void PGStudent::study(Course& c) {
-    if (rand()%101 < 20) {
-        // student is slacking off the course.
-        Utils::log(_id, " is slacking off ", c.getName());
-        return;  
-    } 
-    
-    // the student handled the workload during the semester, now
-    // he should try his luck at the exam.
-    takeExam(c);
-}
@@ -0,0 +1,96 @@
+#include <stdint.h>
+#include <algorithm>
+#include "../include/random.h"
+using namespace std;
+
+uint64_t Random::_seed = 0;
+const size_t Random::LANES;
+
+void Random::setSeed(uint64_t seed) {
+    _seed = seed;
+}
+
+uint64_t Random::getSeed() {
+    return _seed;
+}
+
+void Random::draw(size_t student, size_t semester, size_t course,
+                  uint32_t words[WORDS])
+{
+    draw(_seed, student, semester, course, words);
+}
+
+void Random::draw(uint64_t seed, size_t student, size_t semester,
+                  size_t course, uint32_t words[WORDS])
+{
+    // counter: what the draw is for, key: the seed
+    uint32_t c0 = static_cast<uint32_t>(student);
+    uint32_t c1 = static_cast<uint32_t>(static_cast<uint64_t>(student) >> 32);
+    uint32_t c2 = static_cast<uint32_t>(semester);
+    uint32_t c3 = static_cast<uint32_t>(course);
+    uint32_t k0 = static_cast<uint32_t>(seed);
+    uint32_t k1 = static_cast<uint32_t>(seed >> 32);
+
+    for (int round = 0; round < 10; ++round) {
+        uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * c0;
+        uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * c2;
+        uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+        uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+        c1 = static_cast<uint32_t>(p1);
+        c3 = static_cast<uint32_t>(p0);
+        c0 = n0;
+        c2 = n2;
+
+        k0 += 0x9E3779B9u;
+        k1 += 0xBB67AE85u;
+    }
+
+    words[0] = c0;
+    words[1] = c1;
+    words[2] = c2;
+    words[3] = c3;
+}
+
+void Random::draw(uint64_t seed, size_t count, const size_t* students,
+                  size_t semester, size_t course, uint32_t* first,
+                  uint32_t* second)
+{
+    // the rounds above, LANES students at a time
+    uint32_t c0[LANES];
+    uint32_t c1[LANES];
+    uint32_t c2[LANES];
+    uint32_t c3[LANES];
+
+    for (size_t start = 0; start < count; start += LANES) {
+        size_t lanes = min(LANES, count - start);
+        for (size_t i = 0; i < lanes; ++i) {
+            c0[i] = static_cast<uint32_t>(students[start + i]);
+            c1[i] = static_cast<uint32_t>(static_cast<uint64_t>(students[start + i]) >> 32);
+            c2[i] = static_cast<uint32_t>(semester);
+            c3[i] = static_cast<uint32_t>(course);
+        }
+
+        uint32_t k0 = static_cast<uint32_t>(seed);
+        uint32_t k1 = static_cast<uint32_t>(seed >> 32);
+        for (int round = 0; round < 10; ++round) {
+            for (size_t i = 0; i < lanes; ++i) {
+                uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * c0[i];
+                uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * c2[i];
+                uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1[i] ^ k0;
+                uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3[i] ^ k1;
+                c1[i] = static_cast<uint32_t>(p1);
+                c3[i] = static_cast<uint32_t>(p0);
+                c0[i] = n0;
+                c2[i] = n2;
+            }
+
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+
+        for (size_t i = 0; i < lanes; ++i) {
+            first[start + i] = c0[i];
+            second[start + i] = c1[i];
+        }
+    }
+}
@@ -1,9 +1,10 @@
 #include <iostream>
-#include <fstream>
 #include <vector>
 #include <string>
 #include <cstdlib>
 #include <ctime>
+#include <cstring>
+#include <algorithm>
 
 #include "../include/typedef.h"
 
@@ -20,24 +21,199 @@
 #include "../include/imageoperations.h"
 
 #include "../include/utils.h"
+#include "../include/conffile.h"
+#include "../include/random.h"
+#include "../include/semesterengine.h"
+#include "../include/tableengine.h"
+#include "../include/ensemble.h"
+#include "../include/checkpoint.h"
+#include "../include/curriculum.h"
+#include "../include/activestudents.h"
  
 using namespace std;
 
+static void sortStudents(Students& students) {
+    // sorted by id, once. a student used to be inserted before the ones
+    // with the same id, so students sharing an id go last read first.
+    // the keys are sorted rather than the students, so comparing never
+    // has to reach into the objects.
+    size_t count = students.size();
+    vector<pair<size_t, size_t> > keys(count);
+    bool sorted = true;
+    for (size_t i = 0; i < count; ++i) {
+        keys[i] = make_pair(students[i]->getId(), count - 1 - i);
+        if (i > 0 && keys[i-1].first >= keys[i].first) {
+            sorted = false;
+        }
+    }
+
+    // students.conf in increasing id order needs nothing
+    if (sorted) {
+        return;
+    }
+
+    sort(keys.begin(), keys.end());
+    Students by_id(count);
+    for (size_t i = 0; i < count; ++i) {
+        by_id[i] = students[count - 1 - keys[i].second];
+    }
+    students.swap(by_id);
+}
+
+static bool writeCheckpoint(const string& filename, size_t semester,
+                            bool malag, bool binary_log, Students& students,
+                            size_t course_count)
+{
+    CheckpointHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = CHECKPOINT_VERSION;
+    header.semester = semester;
+    header.seed = Random::getSeed();
+    header.student_count = students.size();
+    header.course_count = course_count;
+    header.malag = malag;
+    header.binary_log = binary_log;
+
+    // the log has to be in the file up to here before the checkpoint
+    // can say so
+    if (!Utils::syncLog(header.log_size)) {
+        return false;
+    }
+
+    return saveCheckpoint(filename, header, students);
+}
+
+static void cleanUp(Courses& CS_courses, Courses& PG_courses,
+                    Courses& elective_courses, Students& students)
+{
+    for (Courses::iterator it = CS_courses.begin();
+         it < CS_courses.end();
+         ++it)
+    {
+        delete *it;
+        *it = 0;
+    }
+    
+    for (Courses::iterator it = PG_courses.begin();
+         it < PG_courses.end();
+         ++it)
+    {
+        delete *it;
+        *it = 0;
+    }
+    
+
+    for (Courses::iterator it = elective_courses.begin();
+         it < elective_courses.end();
+         ++it) 
+    {
+        delete *it;
+        *it = 0;
+    }
+
+    for (Students::iterator it = students.begin();
+         it < students.end();
+         ++it)
+    {
+        delete *it;
+        *it = 0;
+    }
+}
+
 int main(int argc, char* argv[]) {
-    srand(time(NULL));
+    // --binary-log FILE: log the events to FILE as binary records instead
+    // of random.log, bin/decodelog writes the text from it.
+    // --seed N: the seed of every draw, a run is the same for the same
+    // seed. without it the time is used, like before.
+    // --threads N: run every semester on N threads, random.log comes out
+    // the same as without it.
+    // --table: run the semesters on flat tables instead of the objects,
+    // random.log comes out the same too.
+    // --ensemble N: load the confs once and simulate N universes on
+    // --threads threads (all cores without it), seeded from --seed on,
+    // then print the graduation and pass rates instead of any log.
+    // --checkpoint FILE: save the progress to FILE between semesters.
+    // --resume FILE: carry on from the checkpoint in FILE, the log of
+    // the interrupted run is cut where the checkpoint was saved and
+    // continued, as if the run never stopped.
+    // other arguments keep their place: MALAG=no first, and anything
+    // after it skips the images.
+    string binary_log;
+    uint64_t seed = time(NULL);
+    size_t threads = 0;
+    bool table = false;
+    size_t universes = 0;
+    string checkpoint;
+    string resume;
+    int plain_args = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (string(argv[i]) == "--binary-log" && i+1 < argc) {
+            binary_log = argv[++i];
+        } else if (string(argv[i]) == "--seed" && i+1 < argc) {
+            seed = strtoull(argv[++i], 0, 10);
+        } else if (string(argv[i]) == "--threads" && i+1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (string(argv[i]) == "--table") {
+            table = true;
+        } else if (string(argv[i]) == "--ensemble" && i+1 < argc) {
+            universes = atoi(argv[++i]);
+        } else if (string(argv[i]) == "--checkpoint" && i+1 < argc) {
+            checkpoint = argv[++i];
+        } else if (string(argv[i]) == "--resume" && i+1 < argc) {
+            resume = argv[++i];
+        } else {
+            ++plain_args;
+        }
+    }
+
+    if (table && threads > 0) {
+        cout << "--table can't be used with --threads." << endl;
+        return 1;
+    }
+
+    if ((!checkpoint.empty() || !resume.empty()) && (table || universes > 0)) {
+        cout << "--checkpoint and --resume can't be used with --table or --ensemble." << endl;
+        return 1;
+    }
+
+    CheckpointHeader resumed;
+    if (!resume.empty()) {
+        if (!readCheckpointHeader(resume, resumed)
+            || resumed.binary_log != !binary_log.empty())
+        {
+            cout << "Unable to resume from " << resume << "." << endl;
+            return 1;
+        }
+
+        // the draws go on from the interrupted run's seed
+        seed = resumed.seed;
+    }
+    Random::setSeed(seed);
 
-    // clean log file
-    ofstream log;
-    log.open("random.log");
-    if (!log.is_open()) {
+    if (universes > 0 && !binary_log.empty()) {
+        cout << "--ensemble writes no log." << endl;
+        return 1;
+    }
+
+    // clean log file, it is written in the background from here on
+    if (!resume.empty()) {
+        if (!Utils::resumeLog(binary_log.empty() ? "random.log" : binary_log,
+                              !binary_log.empty(), resumed.log_size))
+        {
+            cout << "Unable to open log file." << endl;
+            return 1;
+        }
+    } else if (universes == 0 && !Utils::openLog(binary_log.empty() ? "random.log" : binary_log, 
+                        !binary_log.empty())) 
+    {
         cout << "Unable to open log file." << endl;
         return 1;
     }
-    log.close();
 
-    ifstream conf;
-    string line;
-    vector<string> data;
+    ConfFile conf;
+    string_view line;
+    Fields data;
     bool malag = true;
 
     if (argc > 1) {
@@ -49,6 +225,8 @@ int main(int argc, char* argv[]) {
     Courses CS_courses;
     Courses PG_courses;
     Courses elective_courses;
+    // all of them, in courses.conf order
+    Courses all_courses;
 
     Students students;
 
@@ -56,87 +234,142 @@ int main(int argc, char* argv[]) {
     size_t CS_elective_courses = 0;
     size_t PG_elective_courses = 0;
 
-    conf.open("curriculum.conf");
-    if (!conf.is_open()) {
+    if (!conf.open("curriculum.conf")) {
         cout << "Unable to read curriculum configuration." << endl;
         return 1;
     }
 
-    if (getline(conf, line)) {
+    if (conf.readLine(line)) {
         // first line consists of NUMBER_OF_SEMESTERS=x
-        semesters = atoi(line.substr(line.find("=")+1).c_str());
+        semesters = ConfFile::toInt(line.substr(line.find("=")+1));
     }
     
     // read dept,required_elective_courses data
-    while (getline(conf, line)) {
-        data = Utils::str_split(line, ',');    
+    while (conf.readFields(data, ',')) {
+        if (data.size() < 2) {
+            continue;
+        }
+
         if (data[0] == "CS") {
-            CS_elective_courses = atoi(data[1].c_str());
+            CS_elective_courses = ConfFile::toInt(data[1]);
         } else if (data[0] == "PG") {
-            PG_elective_courses = atoi(data[1].c_str());
+            PG_elective_courses = ConfFile::toInt(data[1]);
         }
     }
     
     conf.close();
     
-    conf.open("courses.conf");
-    if (!conf.is_open()) {
+    if (!conf.open("courses.conf")) {
         cout << "Unable to read courses configuration." << endl;
         return 1;
     }
 
-    while (getline(conf, line)) {
-        data = Utils::str_split(line, ',');    
+    while (conf.readFields(data, ',')) {
+        // data: DEPT,NAME,SEMESTER,MIN_GRADE
+        if (data.size() < 4) {
+            continue;
+        }
+
+        size_t index = all_courses.size();
         if (data[0] == "CS") {
-            CS_courses.push_back(new CSCourse(data));
+            CS_courses.push_back(new CSCourse(data, index));
+            all_courses.push_back(CS_courses.back());
         } else if (data[0] == "PG") {
-            PG_courses.push_back(new PGCourse(data));
+            PG_courses.push_back(new PGCourse(data, index));
+            all_courses.push_back(PG_courses.back());
         } else if (data[0] == "ELECTIVE") {
-            elective_courses.push_back(new ElectiveCourse(data));
+            elective_courses.push_back(new ElectiveCourse(data, index));
+            all_courses.push_back(elective_courses.back());
         }
     }
 
     conf.close();
-    
-    conf.open("students.conf");
-    if (!conf.is_open()) {
-        cout << "Unable to read students configuration." << endl;
-        return 1;
+    if (resume.empty()) {
+        Utils::logCourses(all_courses);
     }
     
-    log.open("random.log", ios::app);
-    if (!log.is_open()) {
-        cout << "Unable to open log file." << endl;
+    if (!conf.open("students.conf")) {
+        cout << "Unable to read students configuration." << endl;
         return 1;
     }
-    while (getline(conf, line)) {
-        data = Utils::str_split(line, ',');    
+
+    while (conf.readFields(data, ',')) {
+        // data: ID,DEPT,IMAGE
+        if (data.size() < 3) {
+            continue;
+        }
+
         Student* student;
         if (data[1] == "CS") {
-            student = new CSStudent(data, CS_elective_courses);
+            student = new CSStudent(data, CS_elective_courses, all_courses.size());
         } else if (data[1] == "PG") {
-            student = new PGStudent(data, PG_elective_courses);
-            if (!malag) {
-                Utils::log(student->getId(), " is being denied his education.");
+            student = new PGStudent(data, PG_elective_courses, all_courses.size());
+            if (!malag && resume.empty()) {
+                Utils::log(LOG_DENIED, student->getId());
             }
         }
-        
-        Students::iterator it = students.begin();
-        for ( ; it < students.end() && (*it)->getId() < student->getId();
-             ++it)
-        {
-            //iterator stops in the place
-            //where we want to insert the new student
-            //(we are sorting the students' vector)
-        }
-        students.insert(it, student);
+
+        students.push_back(student);
     }
-    log.close(); 
     conf.close();
 
+    sortStudents(students);
+
+    if (universes > 0) {
+        Ensemble ensemble(students, CS_courses, PG_courses, elective_courses,
+                          all_courses, malag, semesters,
+                          CS_courses.size() + CS_elective_courses,
+                          PG_courses.size() + PG_elective_courses);
+        ensemble.run(universes, seed, threads);
+        ensemble.print(cout);
+
+        cleanUp(CS_courses, PG_courses, elective_courses, students);
+        return 0;
+    }
+
+    size_t first_semester = 1;
+    if (!resume.empty()) {
+        if (resumed.malag != malag || !loadCheckpoint(resume, students, all_courses)) {
+            cout << "Unable to resume from " << resume << "." << endl;
+            return 1;
+        }
+        first_semester = resumed.semester;
+    }
+
     // start simulation
-    for (size_t semester = 1; semester <= semesters; ++semester) {
-        Utils::log("Semester ", semester, " of Random University.");
+    Curriculum CS_curriculum(CS_courses, elective_courses);
+    Curriculum PG_curriculum(PG_courses, elective_courses);
+    ActiveStudents active(students, CS_curriculum, PG_curriculum, malag);
+    SemesterEngine engine(active, CS_courses, PG_courses, elective_courses,
+                          all_courses.size(), malag, threads);
+    TableEngine* table_engine = 0;
+    if (table) {
+        table_engine = new TableEngine(students, CS_courses, PG_courses,
+                                       elective_courses, all_courses, malag);
+    }
+
+    for (size_t semester = first_semester; semester <= semesters; ++semester) {
+        if (!checkpoint.empty() && semester > first_semester
+            && !writeCheckpoint(checkpoint, semester, malag, !binary_log.empty(),
+                                students, all_courses.size()))
+        {
+            // the run itself is fine, it just can't be resumed from here
+            cout << "Unable to write checkpoint " << checkpoint << "." << endl;
+        }
+
+        Utils::logSemester(semester);
+        if (table_engine != 0) {
+            table_engine->run(semester);
+            continue;
+        }
+
+        // students who were done by the end of last semester
+        // aren't visited anymore
+        active.update();
+        if (threads > 0) {
+            engine.run(semester);
+            continue;
+        }
         
         // for each student, find out what is the latest semester
         // he has finished all the courses for.
@@ -147,56 +380,11 @@ int main(int argc, char* argv[]) {
         // ALSO: if he still needs to take elective courses, register him
         // to Student.getElectiveCoursesCount() amount of elective courses.
         
-        for (Students::iterator it = students.begin(); 
-             it < students.end(); 
-             ++it) 
-        {
-            Student* student = *it;
-            
-            // if the MALAG didn't allow the student to study,
-            // we shouldn't produce any output for such students.
-            if (student->getDept() == "PG" && !malag) {
-                continue;
-            }
-
-            if (!student->hasSemesterCoursesLeft()) {
-                Courses* deptCourses;
-               
-                if (student->getDept() == "CS") {
-                    deptCourses = &CS_courses;
-                } else if (student->getDept() == "PG") {
-                    deptCourses = &PG_courses;
-                }
-                
-                for (Courses::iterator it2 = (*deptCourses).begin();
-                     it2 < (*deptCourses).end();
-                     ++it2)
-                {
-                    Course* course = *it2;
-                    if (course->getSemester() == student->getCurrentSemester())
-                    {
-                        student->addSemesterCourse(*course);
-                    }
-                }
-            }
-
-            int elective_courses_count = student->getElectiveCoursesCount();
-            if (elective_courses_count > 0) {
-                for (Courses::iterator it2 = elective_courses.begin();
-                     it2 < elective_courses.end() 
-                     && elective_courses_count > 0;
-                     ++it2)
-                {
-                    Course* course = *it2;
-                    if (semester%2 == course->getSemester()%2
-                        && !student->hasCompleted(*course)) 
-                    {
-                        student->addElectiveCourse(*course);
-                        elective_courses_count--;
-                    }
-                }
-            }
-            
+        // if the MALAG didn't allow PG students to study, they aren't
+        // active, so no output is produced for them.
+        for (size_t i = 0; i < active.size(); ++i) {
+            Student* student = active.getStudent(i);
+            student->planSemester(semester, active.getCurriculum(i));
             student->startSemester(semester);
         }
 
@@ -204,7 +392,7 @@ int main(int argc, char* argv[]) {
              it < CS_courses.end();
              ++it)
         {
-            (*it)->teach();
+            (*it)->teach(semester);
         }
         
         if (malag) {
@@ -212,7 +400,7 @@ int main(int argc, char* argv[]) {
                  it < PG_courses.end();
                  ++it)
             {
-                (*it)->teach();
+                (*it)->teach(semester);
             }
         }
 
@@ -220,43 +408,48 @@ int main(int argc, char* argv[]) {
              it < elective_courses.end();
              ++it)
         {
-            (*it)->teach();
+            (*it)->teach(semester);
         }
     }
 
-    // open output log file    
-    log.open("random.log", ios::app);
-    if (!log.is_open()) {
-        cout << "Unable to open log file." << endl;
-        return 1;
-    }
-
     // announce graduation status
     size_t dept_courses_count = 0;
-    for (Students::iterator it = students.begin();
-         it < students.end();
-         ++it)
-    {
-        Student* student = *it;
+    vector<bool> graduated(students.size(), false);
+    for (size_t i = 0; i < students.size(); ++i) {
+        Student* student = students[i];
         if (student->getDept() == "CS") {
             dept_courses_count = CS_courses.size() + CS_elective_courses;
         } else if (student->getDept() == "PG") {
             dept_courses_count = PG_courses.size() + PG_elective_courses;
+        }
 
-            // if the MALAG didn't allow the student to study,
-            // we shouldn't produce any output for such students.
-            if (!malag) {
-                continue;
-            }
+        if (table_engine != 0) {
+            graduated[i] = table_engine->hasGraduated(i, dept_courses_count);
+        } else {
+            graduated[i] = student->hasGraduated(dept_courses_count);
         }
 
-        if (student->hasGraduated(dept_courses_count)) {
-            Utils::log(student->getId(), " has graduated");
+        // if the MALAG didn't allow the student to study,
+        // we shouldn't produce any output for such students.
+        if (student->getDept() == "PG" && !malag) {
+            continue;
+        }
+
+        if (graduated[i]) {
+            Utils::log(LOG_GRADUATED, student->getId());
         } else {
-            Utils::log(student->getId(), " has not graduated");
+            Utils::log(LOG_NOT_GRADUATED, student->getId());
         }
     }
-    log.close();
+
+    delete table_engine;
+    table_engine = 0;
+
+    // the log is complete, wait for the writer to get it all out
+    if (!Utils::closeLog()) {
+        cout << "Unable to write log file." << endl;
+        return 1;
+    }
 
     size_t CS_students_count=0;
     size_t PG_students_count=0;
@@ -273,16 +466,13 @@ int main(int argc, char* argv[]) {
         }
     }
 
-    if (argc < 3) {
+    if (plain_args < 2) {
         ImageOperations opr;
         ImageLoader CS_image(100, 100*CS_students_count);
         ImageLoader PG_image(100, 100*PG_students_count);
         size_t i = 0, j = 0;
-        for (Students::iterator it = students.begin();
-             it < students.end();
-             ++it)
-        {
-            Student* student = *it;
+        for (size_t k = 0; k < students.size(); ++k) {
+            Student* student = students[k];
             ImageLoader current_student(100, 100); // frame
             ImageLoader source_image(student->getImage());
             cv::Mat student_image;
@@ -291,7 +481,7 @@ int main(int argc, char* argv[]) {
 
             if (student->getDept() == "CS"){
                 //turn to greyscale if needed
-                if (student->hasGraduated(CS_courses.size() + CS_elective_courses)) {
+                if (graduated[k]) {
                     student_image = cv::imread(student->getImage());
                 } else {
 //                    opr.rgb_to_greyscale(current_student.getImage(), current_student.getImage());
@@ -304,7 +494,7 @@ int main(int argc, char* argv[]) {
                 ++i;
             } else {
                 //turn to greyscale if needed
-                if (student->hasGraduated(PG_courses.size() + PG_elective_courses)) {
+                if (graduated[k]) {
                     student_image = cv::imread(student->getImage());
                 } else {
 //                    opr.rgb_to_greyscale(current_student.getImage(), current_student.getImage());
@@ -330,36 +520,5 @@ int main(int argc, char* argv[]) {
     // clean everything!
 //    cv::destroyAllWindows();
 
-    for (Courses::iterator it = CS_courses.begin();
-         it < CS_courses.end();
-         ++it)
-    {
-        delete *it;
-        *it = 0;
-    }
-    
-    for (Courses::iterator it = PG_courses.begin();
-         it < PG_courses.end();
-         ++it)
-    {
-        delete *it;
-        *it = 0;
-    }
-    
-
-    for (Courses::iterator it = elective_courses.begin();
-         it < elective_courses.end();
-         ++it) 
-    {
-        delete *it;
-        *it = 0;
-    }
-
-    for (Students::iterator it = students.begin();
-         it < students.end();
-         ++it)
-    {
-        delete *it;
-        *it = 0;
-    }
+    cleanUp(CS_courses, PG_courses, elective_courses, students);
 }
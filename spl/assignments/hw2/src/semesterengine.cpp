@@ -0,0 +1,195 @@
+#include <vector>
+#include <algorithm>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include "../include/semesterengine.h"
+#include "../include/student.h"
+#include "../include/course.h"
+#include "../include/utils.h"
+using namespace std;
+
+SemesterEngine::SemesterEngine(ActiveStudents& students, Courses& CS_courses,
+                               Courses& PG_courses, Courses& elective_courses,
+                               size_t course_count, bool malag, size_t threads):
+    _students(students),
+    _threads(threads),
+    _semester(0),
+    _teaching(),
+    _registrations(),
+    _rosters(course_count),
+    _first_seat(),
+    _lines(),
+    _next_chunk(0),
+    _workers(),
+    _mutex(),
+    _step_ready(),
+    _step_done(),
+    _step(0),
+    _chunks(0),
+    _step_count(0),
+    _working(0),
+    _stopping(false)
+{
+    // CS courses first, then PG ones if the MALAG allowed them, then
+    // the electives, like the sequential run teaches them.
+    _teaching.insert(_teaching.end(), CS_courses.begin(), CS_courses.end());
+    if (malag) {
+        _teaching.insert(_teaching.end(), PG_courses.begin(), PG_courses.end());
+    }
+    _teaching.insert(_teaching.end(), elective_courses.begin(),
+                     elective_courses.end());
+
+    for (size_t i = 0; i < _threads; ++i) {
+        _workers.create_thread(boost::bind(&SemesterEngine::work, this));
+    }
+}
+
+SemesterEngine::~SemesterEngine() {
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        _stopping = true;
+    }
+    _step_ready.notify_all();
+    _workers.join_all();
+}
+
+void SemesterEngine::run(size_t semester) {
+    _semester = semester;
+
+    // every chunk of students registers and studies
+    size_t chunks = (_students.size() + STUDENT_CHUNK - 1) / STUDENT_CHUNK;
+    _registrations.resize(chunks);
+    _lines.resize(chunks);
+    runWorkers(&SemesterEngine::studyChunk, chunks);
+
+    // merge: students join the courses chunk by chunk, then the lines
+    // of the registrations go out in the same order.
+    for (size_t i = 0; i < _rosters.size(); ++i) {
+        _rosters[i].clear();
+    }
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        const vector<Registration>& registrations = _registrations[chunk];
+        for (size_t i = 0; i < registrations.size(); ++i) {
+            _rosters[registrations[i].course->getIndex()].push_back(&registrations[i]);
+        }
+        Utils::appendLog(_lines[chunk]);
+    }
+
+    // the outcomes are reported course by course, in teaching order,
+    // split in chunks of seats so one big course doesn't take a thread.
+    _first_seat.assign(1, 0);
+    for (size_t i = 0; i < _teaching.size(); ++i) {
+        size_t seats = _rosters[_teaching[i]->getIndex()].size();
+        _first_seat.push_back(_first_seat.back() + seats);
+    }
+
+    chunks = (_first_seat.back() + SEAT_CHUNK - 1) / SEAT_CHUNK;
+    _lines.resize(max(chunks, _lines.size()));
+    runWorkers(&SemesterEngine::reportChunk, chunks);
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        Utils::appendLog(_lines[chunk]);
+    }
+}
+
+void SemesterEngine::runWorkers(Step step, size_t chunks) {
+    // always on the workers: a worker's lines are held, and the calling
+    // thread's lines go out as they are logged.
+    boost::mutex::scoped_lock lock(_mutex);
+    _step = step;
+    _chunks = chunks;
+    _next_chunk = 0;
+    _working = _threads;
+    _step_count++;
+    _step_ready.notify_all();
+
+    while (_working > 0) {
+        _step_done.wait(lock);
+    }
+}
+
+void SemesterEngine::work() {
+    Utils::holdLog();
+    size_t steps_done = 0;
+    for (;;) {
+        Step step;
+        size_t chunks;
+        {
+            boost::mutex::scoped_lock lock(_mutex);
+            while (_step_count == steps_done && !_stopping) {
+                _step_ready.wait(lock);
+            }
+            if (_stopping) {
+                return;
+            }
+
+            steps_done = _step_count;
+            step = _step;
+            chunks = _chunks;
+        }
+
+        for (;;) {
+            size_t chunk = _next_chunk.fetch_add(1);
+            if (chunk >= chunks) {
+                break;
+            }
+
+            (this->*step)(chunk);
+            Utils::takeLog(_lines[chunk]);
+        }
+
+        boost::mutex::scoped_lock lock(_mutex);
+        if (--_working == 0) {
+            _step_done.notify_one();
+        }
+    }
+}
+
+void SemesterEngine::studyChunk(size_t chunk) {
+    vector<Registration>& registrations = _registrations[chunk];
+    registrations.clear();
+
+    Courses courses;
+    size_t end = min((chunk + 1) * STUDENT_CHUNK, _students.size());
+    for (size_t i = chunk * STUDENT_CHUNK; i < end; ++i) {
+        Student* student = _students.getStudent(i);
+        student->planSemester(_semester, _students.getCurriculum(i));
+
+        student->getRegistrations(_semester, courses);
+        for (size_t j = 0; j < courses.size(); ++j) {
+            Utils::log(LOG_TAKING, student->getId(), courses[j]);
+        }
+
+        // the outcomes don't depend on what the student passes meanwhile,
+        // so the courses are passed right away. only this thread touches
+        // the student.
+        for (size_t j = 0; j < courses.size(); ++j) {
+            Registration registration;
+            registration.student = student;
+            registration.course = courses[j];
+            registration.outcome = student->resolve(*courses[j], _semester);
+            if (registration.outcome == LOG_PASSED) {
+                student->pass(*courses[j]);
+            }
+            registrations.push_back(registration);
+        }
+    }
+}
+
+void SemesterEngine::reportChunk(size_t chunk) {
+    size_t seat = chunk * SEAT_CHUNK;
+    size_t end = min(seat + SEAT_CHUNK, _first_seat.back());
+
+    // the taught course the first seat of the chunk belongs to
+    size_t course = upper_bound(_first_seat.begin(), _first_seat.end(), seat)
+                    - _first_seat.begin() - 1;
+    for ( ; seat < end; ++seat) {
+        while (seat >= _first_seat[course + 1]) {
+            ++course;
+        }
+
+        Course* taught = _teaching[course];
+        const Registration& registration =
+            *_rosters[taught->getIndex()][seat - _first_seat[course]];
+        Utils::log(registration.outcome, registration.student->getId(), taught);
+    }
+}
@@ -1,100 +1,150 @@
 #include "../include/typedef.h"
-#include "../include/utils.h"
 #include "../include/student.h"
 #include "../include/course.h"
+#include "../include/conffile.h"
+#include "../include/checkpoint.h"
+#include "../include/curriculum.h"
+#include "../include/random.h"
 #include <vector>
 #include <string>
-#include <cstdlib>
 #include <cmath>
 #include <fstream>
 using namespace std;
 
-Student::Student(std::vector<std::string> data, size_t elective_courses_count):
-    _id(atoi(data[0].c_str())),
+Student::Student(const Fields& data, size_t elective_courses_count,
+                 size_t course_count):
+    _id(ConfFile::toInt(data[0])),
     _dept(data[1]),
     _image(data[2]),
     _elective_courses_count(elective_courses_count),
-    _passed_courses(),
     _current_semester(1),
     _semester_courses(),
-    _elective_courses()
+    _elective_courses(),
+    _semester_courses_left(0),
+    _elective_courses_left(0),
+    _passed(course_count, false),
+    _pending_semester(course_count, false),
+    _pending_electives(course_count, false),
+    _passed_count(0)
 {
 }
 
-void Student::takeExam(Course& c) {
-    if (10*sqrt(rand()%101) < c.getMinGrade()) {
+LogEvent Student::resolve(Course& c, size_t semester) {
+    // one draw for the workload, one for the exam
+    uint32_t draws[Random::WORDS];
+    Random::draw(_id, semester, c.getIndex(), draws);
+
+    if (draws[0]%101 < getDropChance()) {
+        // the student didn't handle the workload and dropped the course.
+        return getDropEvent();
+    }
+
+    // the student handled the workload during the semester, now
+    // they should try their luck at the exam.
+    return takeExam(c, draws[1]);
+}
+
+LogEvent Student::takeExam(Course& c, uint32_t draw) {
+    if (10*sqrt(draw%101) < c.getMinGrade()) {
         // the student failed the exam.
-        Utils::log(_id, " took ", c.getName(), " and finished UNSUCCESSFULLY");
-        return;
+        return LOG_FAILED;
     }
 
     // the student has passed the course successfully!
-    _passed_courses.push_back(&c);
+    return LOG_PASSED;
+}
+
+void Student::pass(Course& c) {
+    _passed[c.getIndex()] = true;
+    _passed_count++;
 
     // complete the course (update semester courses vector,
     // elective courses count, etc.)
     completeCourse(c);
-
-    Utils::log(_id, " took ", c.getName(), " and finished SUCCESSFULLY");
 }
 
 void Student::completeCourse(Course& c) {
     // if the course was an elective one, 
     // decrease the elective courses count
-    if (c.getDept() == "ELECTIVE") {
-        // remove the course from elective courses list
-        for (Courses::iterator it = _elective_courses.begin();
-             it < _elective_courses.end();
-             ++it)
-        {
-            if (c.getName() == (*it)->getName()) {
-                _elective_courses.erase(it);
-                break;
-            }
-        }
+    if (_pending_electives[c.getIndex()]) {
+        _elective_courses_left--;
         return;
     }
 
-    for (Courses::iterator it = _semester_courses.begin();
-         it < _semester_courses.end();
-         ++it)
-    {
-        if ((*it)->getName() == c.getName()) {
-            _semester_courses.erase(it);
-            break;
+    if (_pending_semester[c.getIndex()]) {
+        _semester_courses_left--;
+        if (_semester_courses_left == 0) {
+            _current_semester++;
         }
     }
+}
 
-    if (_semester_courses.size() == 0) {
-        _current_semester++;
+void Student::dropPassed(Courses& courses, vector<bool>& pending) {
+    // keeps the order of the courses left
+    size_t left = 0;
+    for (size_t i = 0; i < courses.size(); ++i) {
+        size_t index = courses[i]->getIndex();
+        if (_passed[index]) {
+            pending[index] = false;
+        } else {
+            courses[left++] = courses[i];
+        }
     }
+    courses.resize(left);
 }
 
 bool Student::hasSemesterCoursesLeft() {
-    return (_semester_courses.size() != 0);
+    return (_semester_courses_left != 0);
 }
 
 void Student::addSemesterCourse(Course& c) {
     _semester_courses.push_back(&c);
+    _pending_semester[c.getIndex()] = true;
+    _semester_courses_left++;
 }
 
 void Student::addElectiveCourse(Course& c) {
     _elective_courses.push_back(&c);
+    _pending_electives[c.getIndex()] = true;
+    _elective_courses_left++;
     _elective_courses_count--;
 }
 
-void Student::startSemester(size_t semester) {
-    if (_current_semester%2 == semester%2) {
-        for (Courses::iterator it = _semester_courses.begin();
-             it < _semester_courses.end();
-             ++it)
-        {
-            Course* course = *it;
+void Student::planSemester(size_t semester, const Curriculum& curriculum) {
+    // find out what is the latest semester the student has finished all
+    // the courses for, and take the dept courses of the next one.
+    if (!hasSemesterCoursesLeft()) {
+        const Courses& courses = curriculum.getSemesterCourses(_current_semester);
+        for (size_t i = 0; i < courses.size(); ++i) {
+            addSemesterCourse(*courses[i]);
+        }
+    }
 
-            course->reg(*this);
+    // if the student still needs to take elective courses, take
+    // getElectiveCoursesCount() of the ones given this semester.
+    int elective_courses_count = _elective_courses_count;
+    const Courses& electives = curriculum.getElectiveCourses(semester);
+    for (size_t i = 0; i < electives.size() && elective_courses_count > 0; ++i) {
+        if (!hasCompleted(*electives[i])) {
+            addElectiveCourse(*electives[i]);
+            elective_courses_count--;
         }
     }
-   
+}
+
+void Student::getRegistrations(size_t semester, Courses& courses) {
+    // the dept courses when the student's next semester is odd or even
+    // together with the global semester counter, and the electives
+    // given this semester.
+    dropPassed(_semester_courses, _pending_semester);
+    dropPassed(_elective_courses, _pending_electives);
+
+    courses.clear();
+    if (_current_semester%2 == semester%2) {
+        courses.insert(courses.end(), _semester_courses.begin(),
+                       _semester_courses.end());
+    }
+
     for (Courses::iterator it = _elective_courses.begin();
          it < _elective_courses.end();
          ++it)
@@ -102,22 +152,21 @@ void Student::startSemester(size_t semester) {
         Course* course = *it;
 
         if (semester%2 == course->getSemester()%2) {
-            course->reg(*this);
+            courses.push_back(course);
         }
     }
 }
 
-bool Student::hasCompleted(Course& c) {
-    for (Courses::iterator it = _passed_courses.begin();
-         it < _passed_courses.end();
-         ++it)
-    {
-        if ((*it)->getName() == c.getName()) {
-            return true;
-        }
+void Student::startSemester(size_t semester) {
+    Courses courses;
+    getRegistrations(semester, courses);
+    for (Courses::iterator it = courses.begin(); it < courses.end(); ++it) {
+        (*it)->reg(*this);
     }
+}
 
-    return false;
+bool Student::hasCompleted(Course& c) {
+    return _passed[c.getIndex()];
 }
 
 bool Student::hasGraduated(size_t dept_courses_count) {
@@ -127,13 +176,13 @@ bool Student::hasGraduated(size_t dept_courses_count) {
         return false;
     }
 
-    if (_elective_courses.size() > 0) {
+    if (_elective_courses_left > 0) {
         // the student still has elective courses 
         // TO FINISH before graduating.
         return false;
     }
 
-    if (dept_courses_count > _passed_courses.size()) { 
+    if (dept_courses_count > _passed_count) { 
         // the student didn't finish all the dept courses,
         // so he didn't graduate yet.
         return false;
@@ -144,3 +193,75 @@ bool Student::hasGraduated(size_t dept_courses_count) {
     // so, he graduated from Random University!
     return true;
 }
+
+bool Student::isDone(const Curriculum& curriculum) {
+    // _current_semester only moves on when a dept course is passed, so
+    // with none taken now and none to take next it stays put for good.
+    return _elective_courses_count == 0
+        && _elective_courses_left == 0
+        && _semester_courses_left == 0
+        && curriculum.getSemesterCourses(_current_semester).empty();
+}
+
+void Student::saveProgress(StudentProgress& progress) {
+    // the courses passed this semester would be dropped at the next
+    // registration anyway
+    dropPassed(_semester_courses, _pending_semester);
+    dropPassed(_elective_courses, _pending_electives);
+
+    progress.current_semester = _current_semester;
+    progress.electives_wanted = _elective_courses_count;
+    progress.passed_count = _passed_count;
+
+    progress.passed.assign((_passed.size() + 63) / 64, 0);
+    for (size_t i = 0; i < _passed.size(); ++i) {
+        if (_passed[i]) {
+            progress.passed[i / 64] |= static_cast<uint64_t>(1) << (i % 64);
+        }
+    }
+
+    progress.semester_courses.clear();
+    for (size_t i = 0; i < _semester_courses.size(); ++i) {
+        progress.semester_courses.push_back(_semester_courses[i]->getIndex());
+    }
+
+    progress.elective_courses.clear();
+    for (size_t i = 0; i < _elective_courses.size(); ++i) {
+        progress.elective_courses.push_back(_elective_courses[i]->getIndex());
+    }
+}
+
+bool Student::loadProgress(const StudentProgress& progress, Courses& all_courses) {
+    _current_semester = progress.current_semester;
+    _elective_courses_count = progress.electives_wanted;
+    _passed_count = progress.passed_count;
+
+    for (size_t i = 0; i < _passed.size(); ++i) {
+        _passed[i] = (progress.passed[i / 64] >> (i % 64)) & 1;
+        _pending_semester[i] = false;
+        _pending_electives[i] = false;
+    }
+
+    // the lists hold no passed courses, all of them are left
+    _semester_courses.clear();
+    for (size_t i = 0; i < progress.semester_courses.size(); ++i) {
+        if (progress.semester_courses[i] >= all_courses.size()) {
+            return false;
+        }
+        _semester_courses.push_back(all_courses[progress.semester_courses[i]]);
+        _pending_semester[progress.semester_courses[i]] = true;
+    }
+    _semester_courses_left = _semester_courses.size();
+
+    _elective_courses.clear();
+    for (size_t i = 0; i < progress.elective_courses.size(); ++i) {
+        if (progress.elective_courses[i] >= all_courses.size()) {
+            return false;
+        }
+        _elective_courses.push_back(all_courses[progress.elective_courses[i]]);
+        _pending_electives[progress.elective_courses[i]] = true;
+    }
+    _elective_courses_left = _elective_courses.size();
+
+    return true;
+}
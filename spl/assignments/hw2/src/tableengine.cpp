@@ -0,0 +1,317 @@
+#include <vector>
+#include <algorithm>
+#include "../include/tableengine.h"
+#include "../include/student.h"
+#include "../include/course.h"
+#include "../include/utils.h"
+#include "../include/random.h"
+using namespace std;
+
+// the chance in 100 of quitting (CS) or slacking off (PG) a course, as
+// CSStudent and PGStudent give them
+static const unsigned char DROP_CHANCE[2] = { 25, 20 };
+static const unsigned char DROP_EVENT[2] = { LOG_QUITS, LOG_SLACKING };
+
+TableEngine::TableEngine(Students& students, Courses& CS_courses,
+                         Courses& PG_courses, Courses& elective_courses,
+                         Courses& all_courses, bool malag):
+    _courses(all_courses),
+    _malag(malag),
+    _seed(Random::getSeed()),
+    _logging(true),
+    _required_electives(),
+    _course_dept(all_courses.size()),
+    _course_semester(all_courses.size()),
+    _pass_mark(all_courses.size()),
+    _taken(all_courses.size(), 0),
+    _passes(all_courses.size(), 0),
+    _term_courses(),
+    _electives(),
+    _parity_electives(),
+    _teaching(),
+    _ids(students.size()),
+    _depts(students.size()),
+    _current_semester(students.size(), 1),
+    _electives_wanted(students.size()),
+    _semester_courses_left(students.size(), 0),
+    _elective_courses_left(students.size(), 0),
+    _passed_count(students.size(), 0),
+    _elective_room(0),
+    _taken_electives(),
+    _taken_count(students.size(), 0),
+    _words((all_courses.size() + 63) / 64),
+    _passed(students.size() * _words, 0),
+    _active(),
+    _rosters(all_courses.size()),
+    _roster_ids(),
+    _workload(),
+    _exam(),
+    _drop_chances(),
+    _drop_events(),
+    _outcomes()
+{
+    for (size_t i = 0; i < all_courses.size(); ++i) {
+        Course* course = all_courses[i];
+        if (course->getDept() == "CS") {
+            _course_dept[i] = DEPT_CS;
+        } else if (course->getDept() == "PG") {
+            _course_dept[i] = DEPT_PG;
+        } else {
+            _course_dept[i] = DEPT_ELECTIVE;
+        }
+        _course_semester[i] = course->getSemester();
+        _pass_mark[i] = Course::getPassMark(course->getMinGrade());
+    }
+
+    Courses* dept_courses[2] = { &CS_courses, &PG_courses };
+    for (size_t dept = 0; dept < 2; ++dept) {
+        for (size_t i = 0; i < dept_courses[dept]->size(); ++i) {
+            Course* course = (*dept_courses[dept])[i];
+            size_t semester = course->getSemester();
+            if (_term_courses[dept].size() <= semester) {
+                _term_courses[dept].resize(semester + 1);
+            }
+            _term_courses[dept][semester].push_back(course->getIndex());
+        }
+    }
+
+    for (size_t i = 0; i < elective_courses.size(); ++i) {
+        _electives.push_back(elective_courses[i]->getIndex());
+        _parity_electives[elective_courses[i]->getSemester()%2].push_back(
+            elective_courses[i]->getIndex());
+    }
+
+    // CS courses first, then PG ones if the MALAG allowed them, then
+    // the electives, like the objects are taught.
+    for (size_t i = 0; i < CS_courses.size(); ++i) {
+        _teaching.push_back(CS_courses[i]->getIndex());
+    }
+    if (malag) {
+        for (size_t i = 0; i < PG_courses.size(); ++i) {
+            _teaching.push_back(PG_courses[i]->getIndex());
+        }
+    }
+    _teaching.insert(_teaching.end(), _electives.begin(), _electives.end());
+
+    for (size_t i = 0; i < students.size(); ++i) {
+        Student* student = students[i];
+        _ids[i] = student->getId();
+        _depts[i] = (student->getDept() == "CS") ? DEPT_CS : DEPT_PG;
+        _electives_wanted[i] = student->getElectiveCoursesCount();
+        _required_electives[_depts[i]] = _electives_wanted[i];
+        _elective_room = max(_elective_room, student->getElectiveCoursesCount());
+    }
+    _taken_electives.resize(students.size() * _elective_room);
+    activateStudents();
+}
+
+void TableEngine::run(size_t semester) {
+    for (size_t i = 0; i < _active.size(); ++i) {
+        planSemester(_active[i], semester);
+        registerStudent(_active[i], semester);
+    }
+
+    for (size_t i = 0; i < _teaching.size(); ++i) {
+        teach(_teaching[i], semester);
+    }
+
+    // the students done by now aren't visited anymore
+    size_t left = 0;
+    for (size_t i = 0; i < _active.size(); ++i) {
+        if (!isDone(_active[i])) {
+            _active[left++] = _active[i];
+        }
+    }
+    _active.resize(left);
+}
+
+void TableEngine::activateStudents() {
+    // if the MALAG didn't allow the student to study,
+    // we shouldn't produce any output for such students.
+    _active.clear();
+    for (size_t i = 0; i < _ids.size(); ++i) {
+        if (isStudying(i)) {
+            _active.push_back(i);
+        }
+    }
+}
+
+void TableEngine::reset(uint64_t seed) {
+    _seed = seed;
+    _logging = false;
+
+    for (size_t i = 0; i < _ids.size(); ++i) {
+        _current_semester[i] = 1;
+        _electives_wanted[i] = _required_electives[_depts[i]];
+    }
+    fill(_semester_courses_left.begin(), _semester_courses_left.end(), 0);
+    fill(_elective_courses_left.begin(), _elective_courses_left.end(), 0);
+    fill(_passed_count.begin(), _passed_count.end(), 0);
+    fill(_taken_count.begin(), _taken_count.end(), 0);
+    fill(_passed.begin(), _passed.end(), 0);
+    fill(_taken.begin(), _taken.end(), 0);
+    fill(_passes.begin(), _passes.end(), 0);
+    activateStudents();
+}
+
+void TableEngine::planSemester(size_t student, size_t semester) {
+    // the dept courses of the student's semester, once the ones of the
+    // previous semester are all passed
+    if (_semester_courses_left[student] == 0) {
+        const vector<vector<unsigned> >& terms = _term_courses[_depts[student]];
+        unsigned current = _current_semester[student];
+        _semester_courses_left[student] =
+            (current < terms.size()) ? terms[current].size() : 0;
+    }
+
+    unsigned wanted = _electives_wanted[student];
+    unsigned* taken = &_taken_electives[student * _elective_room];
+    const vector<unsigned>& electives = _parity_electives[semester%2];
+    for (size_t i = 0; i < electives.size() && wanted > 0; ++i) {
+        unsigned course = electives[i];
+        if (!hasPassed(student, course)) {
+            taken[_taken_count[student]++] = course;
+            _elective_courses_left[student]++;
+            _electives_wanted[student]--;
+            wanted--;
+        }
+    }
+}
+
+void TableEngine::registerStudent(size_t student, size_t semester) {
+    // the dept courses of the student's semester are the ones not passed
+    // yet, in courses.conf order, just like the list Student keeps.
+    const vector<vector<unsigned> >& terms = _term_courses[_depts[student]];
+    unsigned current = _current_semester[student];
+    if (current%2 == semester%2 && current < terms.size()) {
+        const vector<unsigned>& courses = terms[current];
+        for (size_t i = 0; i < courses.size(); ++i) {
+            if (!hasPassed(student, courses[i])) {
+                _rosters[courses[i]].push_back(student);
+                if (_logging) {
+                    Utils::log(LOG_TAKING, _ids[student], _courses[courses[i]]);
+                }
+            }
+        }
+    }
+
+    // passed electives are dropped, the others keep their order
+    unsigned* taken = &_taken_electives[student * _elective_room];
+    unsigned left = 0;
+    for (unsigned i = 0; i < _taken_count[student]; ++i) {
+        if (!hasPassed(student, taken[i])) {
+            taken[left++] = taken[i];
+        }
+    }
+    _taken_count[student] = left;
+
+    for (unsigned i = 0; i < left; ++i) {
+        unsigned course = taken[i];
+        if (semester%2 == _course_semester[course]%2) {
+            _rosters[course].push_back(student);
+            if (_logging) {
+                Utils::log(LOG_TAKING, _ids[student], _courses[course]);
+            }
+        }
+    }
+}
+
+void TableEngine::teach(unsigned course, size_t semester) {
+    vector<unsigned>& roster = _rosters[course];
+    if (roster.empty()) {
+        return;
+    }
+
+    // the whole roster is resolved first, with the kernel Course::teach()
+    // uses: nothing a student passes changes the draws.
+    size_t count = roster.size();
+    _roster_ids.resize(count);
+    _drop_chances.resize(count);
+    _drop_events.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        unsigned student = roster[i];
+        _roster_ids[i] = _ids[student];
+        _drop_chances[i] = DROP_CHANCE[_depts[student]];
+        _drop_events[i] = DROP_EVENT[_depts[student]];
+    }
+
+    _workload.resize(count);
+    _exam.resize(count);
+    _outcomes.resize(count);
+    Random::draw(_seed, count, &_roster_ids[0], semester, course,
+                 &_workload[0], &_exam[0]);
+    Course::resolveRoster(count, &_workload[0], &_exam[0], &_drop_chances[0],
+                          &_drop_events[0], _pass_mark[course], &_outcomes[0]);
+
+    _taken[course] += roster.size();
+    for (size_t i = 0; i < roster.size(); ++i) {
+        LogEvent outcome = static_cast<LogEvent>(_outcomes[i]);
+        if (outcome == LOG_PASSED) {
+            pass(roster[i], course);
+            _passes[course]++;
+        }
+        if (_logging) {
+            Utils::log(outcome, _ids[roster[i]], _courses[course]);
+        }
+    }
+
+    // the semester ended. clean the course registration list.
+    roster.clear();
+}
+
+void TableEngine::pass(size_t student, unsigned course) {
+    _passed[student * _words + course / 64] |= static_cast<uint64_t>(1) << (course % 64);
+    _passed_count[student]++;
+
+    if (_course_dept[course] == DEPT_ELECTIVE) {
+        _elective_courses_left[student]--;
+        return;
+    }
+
+    _semester_courses_left[student]--;
+    if (_semester_courses_left[student] == 0) {
+        _current_semester[student]++;
+    }
+}
+
+bool TableEngine::hasPassed(size_t student, unsigned course) const {
+    return (_passed[student * _words + course / 64] >> (course % 64)) & 1;
+}
+
+bool TableEngine::hasGraduated(size_t student, size_t dept_courses_count) const {
+    // the same as Student::hasGraduated()
+    return _electives_wanted[student] == 0
+        && _elective_courses_left[student] == 0
+        && dept_courses_count <= _passed_count[student];
+}
+
+bool TableEngine::isDone(size_t student) const {
+    // the same as Student::isDone()
+    const vector<vector<unsigned> >& terms = _term_courses[_depts[student]];
+    unsigned current = _current_semester[student];
+    return _electives_wanted[student] == 0
+        && _elective_courses_left[student] == 0
+        && _semester_courses_left[student] == 0
+        && (current >= terms.size() || terms[current].empty());
+}
+
+bool TableEngine::isStudying(size_t student) const {
+    // the MALAG may have denied PG students their education
+    return _depts[student] != DEPT_PG || _malag;
+}
+
+Department TableEngine::getDept(size_t student) const {
+    return static_cast<Department>(_depts[student]);
+}
+
+size_t TableEngine::getStudentCount() const {
+    return _ids.size();
+}
+
+size_t TableEngine::getTakenCount(size_t course) const {
+    return _taken[course];
+}
+
+size_t TableEngine::getPassedCount(size_t course) const {
+    return _passes[course];
+}
@@ -1,56 +1,94 @@
 #include "../include/utils.h"
-#include <fstream>
-#include <sstream>
+#include "../include/logger.h"
+#include "../include/eventlog.h"
+#include "../include/course.h"
+#include <string>
+#include <cstring>
 using namespace std;
 
-vector<string> Utils::str_split(string str, char separator) {
-	vector<string> words;
-	string word = ""; 
-    string::iterator it;
-	for (it = str.begin(); it < str.end(); ++it) {
-		if (*it == separator) {
-			words.push_back(word);
-			word = "";
-		} else {
-			word = word + *it;
-		}
-	}
-
-	if (word != "") words.push_back(word);
-	
-	return words;
-}
-
-void Utils::log(string str) {
-    ofstream log;
-    log.open("random.log", ios::app);
-    if (!log.is_open()) {
-        throw ("Unable to open log file.");
+// lines are formatted straight into the calling thread's buffer,
+// no file is opened and no stream built per line.
+static Logger logger;
+static bool binary_log = false;
+static size_t current_semester = 0;
+
+bool Utils::openLog(const string& filename, bool binary) {
+    binary_log = binary;
+    current_semester = 0;
+    return logger.open(filename);
+}
+
+bool Utils::resumeLog(const string& filename, bool binary, uint64_t size) {
+    binary_log = binary;
+    current_semester = 0;
+    return logger.reopen(filename, size);
+}
+
+bool Utils::syncLog(uint64_t& size) {
+    return logger.sync(size);
+}
+
+void Utils::logCourses(const Courses& courses) {
+    if (!binary_log) {
+        // the text names its courses on every line
+        return;
+    }
+
+    string table;
+    for (size_t i = 0; i < courses.size(); ++i) {
+        table += courses[i]->getDept() + "," + courses[i]->getName() + "\n";
+    }
+
+    LogHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LOG_MAGIC, sizeof(header.magic));
+    header.version = LOG_VERSION;
+    header.course_count = courses.size();
+    header.table_size = table.size();
+
+    LogBuffer& buffer = logger.buffer();
+    buffer.write(&header, sizeof(header));
+    buffer.write(table.data(), table.size());
+}
+
+bool Utils::closeLog() {
+    return logger.close();
+}
+
+void Utils::log(LogEvent event, size_t student, Course* course) {
+    LogBuffer& buffer = logger.buffer();
+    if (binary_log) {
+        LogRecord record;
+        record.student = student;
+        record.course = (course != 0) ? course->getIndex() : NO_LOG_COURSE;
+        record.semester = current_semester;
+        record.event = event;
+        record.unused = 0;
+        buffer.write(&record, sizeof(record));
+        return;
+    }
+
+    if (course == 0) {
+        renderEvent(buffer, event, student, current_semester, "", "");
+    } else {
+        renderEvent(buffer, event, student, current_semester,
+                    course->getName(), course->getDept());
     }
-    log << str << std::endl;
-    log.close();
 }
 
-void Utils::log(size_t num, string str) {
-    stringstream ss;
-    ss << num << str;
-    log(ss.str());
+void Utils::logSemester(size_t semester) {
+    current_semester = semester;
+    log(LOG_SEMESTER, 0);
 }
 
-void Utils::log(string str1, size_t num, string str2) {
-    stringstream ss;
-    ss << str1 << num << str2;
-    log(ss.str());
+void Utils::holdLog() {
+    logger.buffer().hold();
 }
 
-void Utils::log(size_t num, string str1, string str2) {
-    stringstream ss;
-    ss << num << str1 << str2;
-    log(ss.str());
+void Utils::takeLog(vector<char>& lines) {
+    logger.buffer().take(lines);
 }
 
-void Utils::log(size_t num, string str1, string str2, string str3) {
-    stringstream ss;
-    ss << num << str1 << str2 << str3;
-    log(ss.str());
+void Utils::appendLog(vector<char>& lines) {
+    logger.append(lines);
 }